@@ -26,6 +26,8 @@
  *          - {@link startup()}: initialize the algorithm for a new optimization.
  *          - {@link next()}: perform the actual optimization only until the next improvement.
  *          - {@link finalize()}: perform the post-optimization process, if required.
+ *
+ *          FP is the type of the fitness policy (see {@link PSO}).
  */
 
 #ifndef HILLCLIMBING_H_
@@ -33,10 +35,12 @@
 
 #include "TH/Search.h"
 
-template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1,
+		class FP = FitnessPolicy<P, pSize, F, fSize, V, vSize> >
 class HillClimbing : public Search<P, pSize, F, fSize, V, vSize> {
 	Solution<P, pSize, F, fSize, V, vSize> **population;
-	FitnessPolicy<P, pSize, F, fSize, V, vSize>* fitnessPolicy;
+	FP* fitnessPolicy;
+	Solution<P, pSize, F, fSize, V, vSize> *candidate;
 
 	unsigned int seed;
 	int nEvals, gb, p, n;
@@ -50,6 +54,7 @@ public:
 
 		population = NULL;
 		fitnessPolicy = NULL;
+		candidate = NULL;
 
 		seed = 1;
 		nEvals = 0;
@@ -58,7 +63,22 @@ public:
 		gb = -1;
 		stuck = false;
 	}
-	~HillClimbing() {}
+	~HillClimbing() {
+		if(candidate != NULL) delete candidate;
+	}
+
+	/**
+	 * @brief Allocate the candidate solution used by the moves.
+	 */
+	void reserve(int populationSize) {
+		if(this->getSearchSpace() == NULL) return;
+		int nDimensions = this->getSearchSpace()->getNDimensions();
+		if(candidate != NULL && candidate->getNDimensions() != nDimensions) {
+			delete candidate;
+			candidate = NULL;
+		}
+		if(candidate == NULL) candidate = new Solution<P, pSize, F, fSize, V, vSize>(nDimensions);
+	}
 
 	/**
 	 * @brief Initialize the algorithm for a new optimization.
@@ -69,9 +89,13 @@ public:
 			throw std::invalid_argument("The population size must be greater than zero.");
 		}
 		population = this->getPopulation();
-		fitnessPolicy = this->getFitnessPolicy();
+		fitnessPolicy = dynamic_cast<FP*>(this->getFitnessPolicy());
+		if(fitnessPolicy == NULL) {
+			throw std::invalid_argument("The fitness policy is not of the type the search algorithm was instantiated for.");
+		}
 		seed = THUtil::getRandomSeed();
 		n = this->getSearchSpace()->getNDimensions();
+		reserve(p);
 		nEvals = 0;
 		gb = 0;
 		stuck = false;
@@ -90,32 +114,51 @@ public:
 
 	/**
 	 * @brief Perform the actual optimization only until the next improvement.
+	 *
+	 * The candidate is a copy of the current individual, made once per individual and sweep.
+	 * Every move changes a single dimension of the candidate, which is then either committed
+	 * to the individual or undone, so that each move only touches the dimension changed.
 	 */
 	void next(int M){
-		Solution<P, pSize, F, fSize, V, vSize> candidate(n);
 		SearchSpace<P>* searchSpace = this->getSearchSpace();
 		Dimension<P> *dim;
+		Position<P, pSize> *moved, *current;
 		int i, d, noImprove = 0;
-		bool found = false;
-		while((!found && noImprove < MAX_NO_IMPROVE) && nEvals < M){
-			for(i=0; i < p && nEvals < M; i++){
+		bool found = false, synced;
+		while((!found && noImprove < MAX_NO_IMPROVE) && nEvals < M && !this->isTimeUp()){
+			for(i=0; i < p && nEvals < M && !this->isTimeUp(); i++){
+				synced = false;
 				for(d=0; d < n && nEvals < M; d++){
 					if(THUtil::randUniformDouble(seed, 0, 1) > percMove) continue;
-					candidate = population[i]; // Copy the solution.
+					if(!synced) {
+						*candidate = population[i]; // Copy the solution.
+						synced = true;
+					}
+					moved = (*candidate)[d];
+					current = (*population[i])[d];
 					dim = searchSpace->getOriginalDimension(d);
-					candidate[d]->sum(step * THUtil::randUniformDouble(seed, dim->getStartPoint(), dim->getEndPoint()));
-					candidate[d]->adjustUpperBound(dim->getEndPoint());
-					candidate[d]->adjustLowerBound(dim->getStartPoint());
-					fitnessPolicy->apply(&candidate);
+					moved->sum(step * THUtil::randUniformDouble(seed, dim->getStartPoint(), dim->getEndPoint()));
+					moved->adjustUpperBound(dim->getEndPoint());
+					moved->adjustLowerBound(dim->getStartPoint());
+					// Only the dimension d has changed.
+					fitnessPolicy->applyDelta(candidate, &d, current->getInternalPosition(), 1);
 					nEvals++;
-					if(fitnessPolicy->firstIsBetter(&candidate, population[i])) {
-						*(*population[i])[d] = candidate[d];
+					if(fitnessPolicy->firstIsBetter(candidate, population[i])) {
+						// Commit the move.
+						*current = moved;
+						*population[i]->getFitness() = candidate->getFitness();
+						*population[i]->getViolation() = candidate->getViolation();
 						if(i != gb && fitnessPolicy->firstIsBetter(population[i], population[gb])){
 							found = true;
 							gb = i;
 						}
 					}
-					else *candidate[d] = (*population[i])[d];
+					else {
+						// Undo the move.
+						*moved = current;
+						*candidate->getFitness() = population[i]->getFitness();
+						*candidate->getViolation() = population[i]->getViolation();
+					}
 				}
 			}
 			if(!found) noImprove++;
@@ -123,6 +166,24 @@ public:
 		if(noImprove == MAX_NO_IMPROVE) stuck = true;
 	}
 
+	/**
+	 * @brief Replace the worst individual by the immigrant, if the immigrant is better.
+	 */
+	bool injectImmigrant(Solution<P, pSize, F, fSize, V, vSize> *immigrant) {
+		if(population == NULL || p < 2) return false;
+		int worst = (gb == 0) ? 1 : 0;
+		for(int i=worst+1; i < p; i++){
+			if(i != gb && fitnessPolicy->firstIsBetter(population[worst], population[i])) worst = i;
+		}
+		if(!fitnessPolicy->firstIsBetter(immigrant, population[worst])) return false;
+		*population[worst] = immigrant;
+		if(fitnessPolicy->firstIsBetter(population[worst], population[gb])){
+			gb = worst;
+			stuck = false;
+		}
+		return true;
+	}
+
 	bool isStuck(){return stuck;}
 
 	int getBestPos(){return gb;}
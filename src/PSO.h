@@ -26,25 +26,58 @@
  *          - {@link startup()}: initialize the algorithm for a new optimization.
  *          - {@link next()}: perform the actual optimization only until the next improvement.
  *          - {@link finalize()}: perform the post-optimization process, if required.
+ *
+ *          FP is the type of the fitness policy. By default it is the FitnessPolicy interface,
+ *          so any policy can be used through virtual calls. When FP is a concrete (final) policy,
+ *          the fitness evaluations and comparisons are bound at compile time and can be inlined
+ *          into the swarm loops (see {@link StaticTHBuilder}).
  */
 
 #ifndef PSO_HPP_
 #define PSO_HPP_
 
 #include "TH/Search.h"
+#include "TH/RandomEngine.h"
 
-template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1,
+		class FP = FitnessPolicy<P, pSize, F, fSize, V, vSize> >
 class PSO : public Search<P, pSize, F, fSize, V, vSize> {
 	Solution<P, pSize, F, fSize, V, vSize> **population;
-	FitnessPolicy<P, pSize, F, fSize, V, vSize>* fitnessPolicy;
+	FP* fitnessPolicy;
+	Population<P, pSize, F, fSize, V, vSize> *personalBests, *velocities;
 	Solution<P, pSize, F, fSize, V, vSize> **pBest;
 	Solution<P, pSize, F, fSize, V, vSize> **v;
+	THRandomEngine *randomEngine;
+	double *coefficients;	// Random coefficients r1 and r2 for every dimension.
+	P *lowerBounds, *upperBounds;
 
-	unsigned int seed;
 	int nEvals, gb, p, n;
 	double w, c1, c2;
 	bool stuck;
 
+	/**
+	 * @brief Fused velocity and position update of one particle.
+	 *
+	 * v = w*v + c1*r1*(pb - x) + c2*r2*(g - x); x = clamp(x + v, lower, upper).
+	 * The particle's positions, velocities and personal best are contiguous, so this
+	 * single pass over the arrays is bound by the memory bandwidth.
+	 */
+	static void updateParticle(Position<P, pSize> * __restrict__ x, Position<P, pSize> * __restrict__ vel,
+			const Position<P, pSize> *pb, const Position<P, pSize> *g, const P *lower, const P *upper,
+			const double *r1, const double *r2, double w, double c1, double c2, int n) {
+		for(int j=0; j < n; j++){
+			const double a = c1 * r1[j], b = c2 * r2[j];
+			for(int k=0; k < pSize; k++){
+				P xv = x[j].internalPosition[k];
+				P vv = (P)(w * vel[j].internalPosition[k] + a * (pb[j].internalPosition[k] - xv) + b * (g[j].internalPosition[k] - xv));
+				vel[j].internalPosition[k] = vv;
+				xv += vv;
+				xv = (xv > upper[j]) ? upper[j] : xv;
+				x[j].internalPosition[k] = (xv < lower[j]) ? lower[j] : xv;
+			}
+		}
+	}
+
 public:
 	PSO(double w, double c1, double c2, int populationSize) : Search<P, pSize, F, fSize, V, vSize>(populationSize) {
 		this->w = w;
@@ -53,10 +86,14 @@ public:
 
 		population = NULL;
 		fitnessPolicy = NULL;
+		personalBests = NULL;
+		velocities = NULL;
 		pBest = NULL;
 		v = NULL;
+		randomEngine = NULL;
+		coefficients = NULL;
+		lowerBounds = upperBounds = NULL;
 
-		seed = 1;
 		nEvals = 0;
 		p = 0;
 		n = 0;
@@ -64,17 +101,45 @@ public:
 		stuck = false;
 	}
 	~PSO() {
-		if(pBest != NULL){
-			for(int i=0; i < p; i++) {
-				delete pBest[i];
-			}
-			delete pBest;
+		release();
+	}
 
-			for(int i=0; i < p; i++){
-				delete v[i];
-			}
-			delete v;
+	/**
+	 * @brief Allocate the particles' buffers for populations of up to populationSize individuals.
+	 */
+	void reserve(int populationSize) {
+		if(this->getSearchSpace() == NULL) return;
+		int nDimensions = this->getSearchSpace()->getNDimensions();
+		if(personalBests != NULL && personalBests->getPopulationSize() >= populationSize
+				&& personalBests->getNDimensions() == nDimensions) return;
+		release();
+		personalBests = new Population<P, pSize, F, fSize, V, vSize>(populationSize, nDimensions);
+		velocities = new Population<P, pSize, F, fSize, V, vSize>(populationSize, nDimensions);
+		pBest = personalBests->getSolutions();
+		v = velocities->getSolutions();
+		randomEngine = new THRandomEngine(THUtil::getRandomSeed());
+		coefficients = (double*) THUtil::alignedAlloc(2 * nDimensions * sizeof(double));
+		lowerBounds = new P[nDimensions];
+		upperBounds = new P[nDimensions];
+	}
+
+	/**
+	 * @brief Release the particles' buffers.
+	 */
+	void release() {
+		if(personalBests != NULL) delete personalBests;
+		if(velocities != NULL) delete velocities;
+		if(randomEngine != NULL) delete randomEngine;
+		if(coefficients != NULL) THUtil::alignedFree(coefficients);
+		if(lowerBounds != NULL) {
+			delete[] lowerBounds;
+			delete[] upperBounds;
 		}
+		personalBests = velocities = NULL;
+		pBest = v = NULL;
+		randomEngine = NULL;
+		coefficients = NULL;
+		lowerBounds = upperBounds = NULL;
 	}
 
 	/**
@@ -86,29 +151,24 @@ public:
 			throw std::invalid_argument("The population size must be greater than zero.");
 		}
 		population = this->getPopulation();
-		fitnessPolicy = this->getFitnessPolicy();
-		seed = THUtil::getRandomSeed();
-		p = this->getPopulationSize();
+		fitnessPolicy = dynamic_cast<FP*>(this->getFitnessPolicy());
+		if(fitnessPolicy == NULL) {
+			throw std::invalid_argument("The fitness policy is not of the type the search algorithm was instantiated for.");
+		}
 		n = this->getSearchSpace()->getNDimensions();
 		nEvals = 0;
 		gb = 0;
 		stuck = false;
 
-		if(pBest == NULL){
-			pBest = new Solution<P, pSize, F, fSize, V, vSize>*[p];
-			for(int i=0; i < p; i++) {
-				pBest[i] = new Solution<P, pSize, F, fSize, V, vSize>(n);
-			}
-		}
-		if(v == NULL) {
-			v = new Solution<P, pSize, F, fSize, V, vSize>*[p];
-			for(int i=0; i < p; i++){
-				v[i] = new Solution<P, pSize, F, fSize, V, vSize>(n);
-			}
+		reserve(p);
+		for(int j=0; j < n; j++){
+			lowerBounds[j] = this->getSearchSpace()->getOriginalDimension(j)->getStartPoint();
+			upperBounds[j] = this->getSearchSpace()->getOriginalDimension(j)->getEndPoint();
 		}
 
 		for(int j, i=0; i < p; i++){
-			for(j=0; j < n; j++) *(*v[i])[j] = THUtil::randUniformDouble(seed, 0, 1);
+			randomEngine->fillUniform(coefficients, n, 0, 1);
+			for(j=0; j < n; j++) *(*v[i])[j] = coefficients[j];
 			*pBest[i] = population[i];
 			if(i != gb && fitnessPolicy->firstIsBetter(population[i], population[gb])){
 				*pBest[i] = population[i];
@@ -131,41 +191,21 @@ public:
 	 * @brief Perform the actual optimization only until the next improvement.
 	 */
 	void next(int M) {
-		SearchSpace<P>* searchSpace = this->getSearchSpace();
-		Dimension<P> *dim;
-		Position<P, pSize> pos1, pos2;
 		bool found = false;
-		int i, j, noImprove = 0;
+		int i, noImprove = 0;
 		double currW = w - (w / M) * nEvals;
-		while(!found && nEvals < M && noImprove < MAX_NO_IMPROVE){
+		while(!found && nEvals < M && noImprove < MAX_NO_IMPROVE && !this->isTimeUp()){
 			for(i=0; i < p; i++){
-				for(j=0; j < n; j++){
-					dim = searchSpace->getOriginalDimension(j);
-					// c1 * RAND_DOUBLE(seed, 0, 1) * (pb[i][j] - G[i][j])
-					pos1 = (*pBest[i])[j];
-					pos1.sub((*population[i])[j]);
-					pos1.mult(c1 * THUtil::randUniformDouble(seed, 0, 1));
-					// c2 * RAND_DOUBLE(seed, 0, 1) * (Gb[j] - G[i][j])
-					pos2 = (*population[gb])[j];
-					pos2.sub((*population[i])[j]);
-					pos2.mult(c2 * THUtil::randUniformDouble(seed, 0, 1));
-
-					// v[i][j] = currW * v[i][j] + c1 * RAND_DOUBLE(seed, 0, 1) * (pb[i][j] - G[i][j])
-					//							 + c2 * RAND_DOUBLE(seed, 0, 1) * (Gb[j] - G[i][j]);
-					pos2.sum(pos1);
-
-					pos1 = (*v[i])[j];
-					pos1.mult(currW);
-					pos1.sum(pos2);
-
-   					*(*v[i])[j] = pos1;
-					(*population[i])[j]->sum((*v[i])[j]);
-					(*population[i])[j]->adjustUpperBound(dim->getEndPoint());
-					(*population[i])[j]->adjustLowerBound(dim->getStartPoint());
-				}
-				fitnessPolicy->apply(population[i]);
-				nEvals++;
+				randomEngine->fillUniform(coefficients, 2 * n, 0, 1);
+				// The global best particle has no social component (Gb - G[i] = 0), so its
+				// personal best is passed instead, keeping the particle unaliased.
+				updateParticle(population[i]->getInternalPositions(), v[i]->getInternalPositions(),
+						pBest[i]->getInternalPositions(),
+						(i != gb) ? population[gb]->getInternalPositions() : pBest[i]->getInternalPositions(),
+						lowerBounds, upperBounds, coefficients, &coefficients[n], currW, c1, (i != gb) ? c2 : 0, n);
 			}
+			FitnessPolicy<P, pSize, F, fSize, V, vSize>::applyBatchOf(fitnessPolicy, population, p);
+			nEvals += p;
 			for(i=0; i < p; i++){
 				if(fitnessPolicy->firstIsBetter(population[i], pBest[i])) {
 					*population[i] = pBest[i];
@@ -181,6 +221,27 @@ public:
 		if(noImprove == MAX_NO_IMPROVE) stuck = true;
 	}
 
+	/**
+	 * @brief Replace the particle with the worst personal best by the immigrant, if the immigrant is better.
+	 *
+	 * The immigrant becomes both the current position and the personal best of the particle.
+	 */
+	bool injectImmigrant(Solution<P, pSize, F, fSize, V, vSize> *immigrant) {
+		if(pBest == NULL || p < 2) return false;
+		int worst = (gb == 0) ? 1 : 0;
+		for(int i=worst+1; i < p; i++){
+			if(i != gb && fitnessPolicy->firstIsBetter(pBest[worst], pBest[i])) worst = i;
+		}
+		if(!fitnessPolicy->firstIsBetter(immigrant, pBest[worst])) return false;
+		*population[worst] = immigrant;
+		*pBest[worst] = immigrant;
+		if(fitnessPolicy->firstIsBetter(population[worst], population[gb])){
+			gb = worst;
+			stuck = false;
+		}
+		return true;
+	}
+
 	bool isStuck(){return stuck;}
 
 	int getBestPos(){return gb;}
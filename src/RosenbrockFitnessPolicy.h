@@ -32,16 +32,29 @@
 #include <mpi.h>
 #include <cfloat>
 
-class RosenbrockFitnessPolicy : public FitnessPolicy<> {
+// Final, so the search algorithms instantiated with this type call it without virtual dispatch.
+class RosenbrockFitnessPolicy final : public FitnessPolicy<> {
 public:
 	RosenbrockFitnessPolicy(){}
 	~RosenbrockFitnessPolicy(){}
 
 	void apply(Solution<>* solution);
 
-	bool firstIsBetter(Solution<>* first, Solution<>* second);
+	void applyDelta(Solution<>* solution, int *changedDims, double *oldValues, int k);
 
-	bool firstIsBetter(Fitness<> *first, Fitness<> *second);
+	bool firstIsBetter(Solution<>* first, Solution<>* second) {
+		if(first != NULL && second == NULL) return true;
+		else if(first == NULL && second != NULL) return false;
+		else if(first == NULL && second == NULL) return false;
+		return first->getFitness()->getFirstValue() < second->getFitness()->getFirstValue();
+	}
+
+	bool firstIsBetter(Fitness<> *first, Fitness<> *second) {
+		if(first != NULL && second == NULL) return true;
+		else if(first == NULL && second != NULL) return false;
+		else if(first == NULL && second == NULL) return false;
+		return first->getFirstValue() < second->getFirstValue();
+	}
 
 	void setWorstFitness(Solution<>* solution);
 
@@ -0,0 +1,86 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file AllocationCounter.h
+ * @class THAllocationCounter
+ * @author Peter Frank Perroni
+ * @brief Opt-in hook to count the heap allocations of a process.
+ * @details The counter is only incremented by the replaced global operators new/new[],
+ *          which are defined when TH_DEFINE_ALLOCATION_OPERATORS is set before including
+ *          this file. Since they are global replacements, this must be done in exactly
+ *          one translation unit of the program (usually the one containing main()).
+ *
+ *          When TH is compiled with TH_COUNT_ALLOCATIONS (see config.h), every TH instance
+ *          counts the allocations performed during its steady-state iterations
+ *          (see {@link TH::getSteadyStateAllocations()}). The DEBUG messages allocate
+ *          memory by themselves (e.g. to open the log files), so DEBUG should be disabled
+ *          while counting.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+struct THAllocationCounter {
+	/**
+	 * @brief Get the process-wide number of allocations counted so far.
+	 */
+	static std::atomic<long long>& count() {
+		static std::atomic<long long> allocations(0);
+		return allocations;
+	}
+};
+
+#ifdef TH_DEFINE_ALLOCATION_OPERATORS
+// The operators must never be inlined: otherwise the compiler pairs the malloc() inside
+// operator new with the free() inside operator delete (-Wmismatched-new-delete).
+#if defined(__GNUC__)
+#define TH_ALLOCATION_OPERATOR __attribute__((noinline))
+#else
+#define TH_ALLOCATION_OPERATOR
+#endif
+
+TH_ALLOCATION_OPERATOR void* operator new(std::size_t size) {
+	THAllocationCounter::count().fetch_add(1, std::memory_order_relaxed);
+	void *ptr = std::malloc((size > 0) ? size : 1);
+	if(ptr == NULL) throw std::bad_alloc();
+	return ptr;
+}
+TH_ALLOCATION_OPERATOR void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+TH_ALLOCATION_OPERATOR void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+TH_ALLOCATION_OPERATOR void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+TH_ALLOCATION_OPERATOR void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+TH_ALLOCATION_OPERATOR void operator delete[](void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+#endif
+
+#endif /* ALLOCATIONCOUNTER_H_ */
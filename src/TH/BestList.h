@@ -28,23 +28,33 @@
 #define BESTLIST_H_
 
 #include "Solution.h"
+#include "SolutionPool.h"
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class BestList {
 	Solution<P, pSize, F, fSize, V, vSize> **bestList;
+	SolutionPool<P, pSize, F, fSize, V, vSize> *pool;
 	int listSize;
 	int n;
 
+	void discard(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		if(pool != NULL && pool->owns(solution)) pool->release(solution);
+		else delete solution;
+	}
+
 public:
 	/**
 	 * @brief Constructor that generates an empty best-list instance.
 	 * @param listSize List size.
 	 * @param n Maximum number of dimensions to be optimized.
+	 * @param pool The pool that provides the Solutions stored by {@link store()}
+	 *             (optional, the Solutions are allocated from the heap when not provided).
 	 */
-	BestList(int listSize, int n){
+	BestList(int listSize, int n, SolutionPool<P, pSize, F, fSize, V, vSize> *pool = NULL){
 		if(listSize <= 0) throw std::invalid_argument("The best list size is invalid.");
 		this->listSize = listSize;
 		this->n = n;
+		this->pool = pool;
 		bestList = new Solution<P, pSize, F, fSize, V, vSize>*[listSize];
 		for(int i=0; i < listSize; i++) bestList[i] = NULL;
 	}
@@ -57,6 +67,7 @@ public:
 		this->listSize = bestList->getListSize();
 		if(bestList == NULL || this->listSize == 0) throw std::invalid_argument("The best list size is invalid.");
 		this->n = bestList->getNDimensions();
+		this->pool = NULL;
 		this->bestList = new Solution<P, pSize, F, fSize, V, vSize>*[listSize];
 		Solution<P, pSize, F, fSize, V, vSize> *solution;
 		for(int i=0; i < listSize; i++) {
@@ -71,9 +82,9 @@ public:
 	 */
 	~BestList() {
 		for(int i=0; i < listSize; i++){
-			if(bestList[i] != NULL) delete bestList[i];
+			if(bestList[i] != NULL) discard(bestList[i]);
 		}
-		delete bestList;
+		delete[] bestList;
 	}
 
 	/**
@@ -101,10 +112,27 @@ public:
 	void set(int idx, Solution<P, pSize, F, fSize, V, vSize> *solution){
 		if(idx < 0 || idx > listSize) throw std::invalid_argument("The best list index is invalid");
 		if(solution == NULL) throw std::invalid_argument("The solution cannot be empty.");
-		if(bestList[idx] != NULL) delete bestList[idx];
+		if(bestList[idx] != NULL) discard(bestList[idx]);
 		bestList[idx] = solution;
 	}
 
+	/**
+	 * @brief Copy a Solution into an element of the list.
+	 *
+	 * Unlike {@link set()}, the list does not keep the Solution received. The contents are
+	 * copied into the existing element, and an empty element takes a Solution from the pool
+	 * (if any), so no memory is allocated once the list is full (or when a pool is used).
+	 *
+	 * @param idx The index in the list to store the Solution (list starts in zero).
+	 * @param solution The Solution instance to copy.
+	 */
+	void store(int idx, Solution<P, pSize, F, fSize, V, vSize> *solution){
+		if(idx < 0 || idx >= listSize) throw std::invalid_argument("The best list index is invalid");
+		if(solution == NULL) throw std::invalid_argument("The solution cannot be empty.");
+		if(bestList[idx] != NULL) *bestList[idx] = solution;
+		else bestList[idx] = (pool != NULL) ? pool->acquire(solution) : new Solution<P, pSize, F, fSize, V, vSize>(solution);
+	}
+
 	int getListSize(){
 		return listSize;
 	}
@@ -34,8 +34,9 @@
 #ifndef BETARELOCATIONSTRATEGYPOLICY_H_
 #define BETARELOCATIONSTRATEGYPOLICY_H_
 
-#include <boost/math/distributions.hpp>
 #include "RelocationStrategyPolicy.h"
+#include "RandomEngine.h"
+#include "THUtil.h"
 
 /**
  * @brief Iterative Partitioning Boost functions.
@@ -48,7 +49,23 @@
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class BetaRelocationStrategyPolicy : public RelocationStrategyPolicy<P, pSize, F, fSize, V, vSize> {
 
-	unsigned int seed;
+	/**
+	 * @brief The arguments of one relocation, shared by the workers.
+	 */
+	struct Relocation {
+		Solution<P, pSize, F, fSize, V, vSize> **population;
+		Dimension<P> *originalDimensions;
+		Position<P, pSize> *parentBest;
+		Region<P> *region;
+		double alpha, beta;
+		int n;
+	};
+
+	THRandomEngine *randomEngine;
+	THRandomEngine **workerEngines;	// One random stream per worker of the thread pool.
+	int nWorkerEngines;
+	double *betaSamples;	// Reusable buffer for the Beta variates of one relocation.
+	long betaSamplesSize;
 	int maxTries, nTries;
 	float K, maxK;
 	double prevBestFitness;
@@ -92,9 +109,48 @@ class BetaRelocationStrategyPolicy : public RelocationStrategyPolicy<P, pSize, F
 		return (firstPass) ? (firstPass=false)+(prevBestFitness=bestFit) : (prevBestFitness=bestFit);
 	}
 
+	void deleteWorkerEngines() {
+		for(int i=0; i < nWorkerEngines; i++) delete workerEngines[i];
+		if(workerEngines != NULL) delete[] workerEngines;
+		workerEngines = NULL;
+		nWorkerEngines = 0;
+	}
+
+	/**
+	 * @brief Relocate the population members [begin, end[, drawing their Beta variates from the engine.
+	 */
+	void relocate(const Relocation &relocation, int begin, int end, THRandomEngine *engine) {
+		int n = relocation.n;
+		// Draw the Beta variates for all dimensions of these population members at once.
+		// Sampling Beta(a, b) directly (ratio of gammas) is equivalent to inverting its CDF at a uniform number.
+		engine->fillBeta(&betaSamples[(long)begin * n], (long)(end - begin) * n, relocation.alpha, relocation.beta);
+		for(int j, k, i=begin; i < end; i++){
+			Solution<P, pSize, F, fSize, V, vSize> *solution = relocation.population[i];
+			solution->reset(relocation.region); // Obtain a new position inside TH instance's sub-region for this population member.
+			// Relocate this individual according to the beta strategy toward the parent best:
+			// pos = pos - beta * (pos - parentBest), limited to the search space boundaries.
+			Position<P, pSize> *positions = solution->getInternalPositions();
+			const double *beta = &betaSamples[(long)i * n];
+			for(j=0; j < n; j++){
+				const P lower = relocation.originalDimensions[j].getStartPoint(), upper = relocation.originalDimensions[j].getEndPoint();
+				P *pos = positions[j].internalPosition;
+				const P *best = relocation.parentBest[j].internalPosition;
+				for(k=0; k < pSize; k++){
+					P value = pos[k] - (pos[k] - best[k]) * beta[j];
+					value = (value > upper) ? upper : value;
+					pos[k] = (value < lower) ? lower : value;
+				}
+			}
+		}
+	}
+
 public:
 	BetaRelocationStrategyPolicy() {
-		seed = THUtil::getRandomSeed();
+		randomEngine = new THRandomEngine(THUtil::getRandomSeed());
+		workerEngines = NULL;
+		nWorkerEngines = 0;
+		betaSamples = NULL;
+		betaSamplesSize = 0;
 		diplacementType = 'L';
 		configIPDisplacementType();
 		maxTries = 0;
@@ -103,7 +159,36 @@ public:
 		prevBestFitness = 0;
 		firstPass = true;
 	}
-	~BetaRelocationStrategyPolicy() {}
+	~BetaRelocationStrategyPolicy() {
+		delete randomEngine;
+		deleteWorkerEngines();
+		if(betaSamples != NULL) THUtil::alignedFree(betaSamples);
+	}
+
+	/**
+	 * @brief Allocate the buffer of Beta variates for populations of up to populationSize individuals.
+	 */
+	void reserve(int populationSize, int nDimensions) {
+		long nSamples = (long)populationSize * nDimensions;
+		if(nSamples > betaSamplesSize) {
+			if(betaSamples != NULL) THUtil::alignedFree(betaSamples);
+			betaSamples = (double*) THUtil::alignedAlloc(nSamples * sizeof(double));
+			betaSamplesSize = nSamples;
+		}
+	}
+
+	/**
+	 * @brief Create the random stream of every worker, seeded from the worker's own seed.
+	 */
+	void setThreadPool(ThreadPool *threadPool) {
+		RelocationStrategyPolicy<P, pSize, F, fSize, V, vSize>::setThreadPool(threadPool);
+		deleteWorkerEngines();
+		if(threadPool == NULL) return;
+		workerEngines = new THRandomEngine*[threadPool->getNThreads()];
+		for(nWorkerEngines=0; nWorkerEngines < threadPool->getNThreads(); nWorkerEngines++){
+			workerEngines[nWorkerEngines] = new THRandomEngine(threadPool->getSeed(nWorkerEngines));
+		}
+	}
 
 	/**
 	 * @brief This method implements the policy to relocate TH instance's population
@@ -142,29 +227,26 @@ public:
 		// Calculate the beta PDF.
 		double betaProb = betaRelocationStrategyData->getBetaStartingPerc() * betaRelocationStrategyData->getBetaMax()
 				* pow(max(betaRelocationStrategyData->getDisplacementRate(), 1e-5), betaRelocationStrategyData->getBetaAccelerationCoef());
-		boost::math::beta_distribution<> distrib(betaRelocationStrategyData->getBetaMax()-betaProb, betaProb);
+
+		Relocation relocation;
+		relocation.population = population;
+		relocation.originalDimensions = region->getDimensionList();
+		relocation.parentBest = iterationData->getParentBest()->getInternalPositions();
+		relocation.region = region;
+		relocation.alpha = betaRelocationStrategyData->getBetaMax() - betaProb;
+		relocation.beta = betaProb;
+		relocation.n = population[0]->getNDimensions();
+		reserve(populationSize, relocation.n);
 
 		// Relocate the population members that were not repositioned on previous processes.
-		Position<P, pSize> pos, tmp;
-		Dimension<P> *dim;
-		map<int, Dimension<P>*> *originalDimensions = region->getOriginalDimensions();
-		Solution<P, pSize, F, fSize, V, vSize> *parentBest = iterationData->getParentBest();
-		int n = population[0]->getNDimensions();
-		for(int j, i=0; i < populationSize; i++){
-			population[i]->reset(region); // Obtain a new position inside TH instance's sub-region for this population member.
-			// Relocate this individual according to the beta strategy toward the parent best.
-			for(j=0; j < n; j++){
-				dim = (*originalDimensions)[j];
-				pos = (*population[i])[j];
-				tmp = pos;
-				tmp.sub((*parentBest)[j]);
-				tmp.mult(quantile(distrib, THUtil::randUniformDouble(seed, 0, 1)));
-				pos.sub(tmp);
-				pos.adjustUpperBound(dim->getEndPoint());
-				pos.adjustLowerBound(dim->getStartPoint());
-				*(*population[i])[j] = pos; //quantile(distrib, THUtil::randUniformDouble(seed, 0, 1)) * (pos - parentBest[j]);
-			}
+		// With a thread pool, every worker relocates its own (fixed) chunk from its own random stream.
+		ThreadPool *threadPool = this->getThreadPool();
+		if(threadPool != NULL && nWorkerEngines == threadPool->getNThreads() && populationSize > 1) {
+			threadPool->parallelFor(populationSize, [this, &relocation](int begin, int end, int worker) {
+				relocate(relocation, begin, end, workerEngines[worker]);
+			});
 		}
+		else relocate(relocation, 0, populationSize, randomEngine);
 	}
 
 	void setIPDisplacementType() {
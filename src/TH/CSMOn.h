@@ -41,8 +41,51 @@ template <class F = double>
 struct t_point{
 	int x;
 	F y;
+	double lnY, log10X, log10Y; // Logarithms used by the regressions, calculated once per point.
 	t_point(int _x, F _y){
 		x = _x, y = _y;
+		lnY = log(y);
+		log10X = log10(x);
+		log10Y = log10(y);
+	}
+};
+
+/**
+ * @brief Running sums of a least-squares fit over a window [first, last] of points.
+ *
+ * The x and y values are accumulated relative to the first point of the window,
+ * which does not change the slope and avoids the cancellation of large sums.
+ * The z values (the response returned by the fit) are accumulated as they are.
+ */
+struct t_window{
+	int first, last;
+	long double x0, y0, n, sx, sy, sz, sxx, sxy;
+
+	void reset(int first, double x0, double y0){
+		this->first = first;
+		last = first - 1;
+		this->x0 = x0, this->y0 = y0;
+		n = sx = sy = sz = sxx = sxy = 0;
+	}
+
+	void add(double x, double y, double z){
+		long double dx = x - x0, dy = y - y0;
+		n++;
+		sx += dx;
+		sy += dy;
+		sz += z;
+		sxx += dx * dx;
+		sxy += dx * dy;
+		last++;
+	}
+
+	/**
+	 * @brief The intercept of the fit: (sum(z) - slope * sum(x)) / n.
+	 */
+	double intercept(){
+		long double S1 = sxy - sx * sy / n;
+		long double S2 = sxx - sx * sx / n;
+		return (double)((sz - (S1 / S2) * (sx + n * x0)) / n);
 	}
 };
 
@@ -53,6 +96,12 @@ class CSMOn : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
 	double R;
 	F minEstimatedFit;
 	vector<t_point<F>> *gb;
+	t_window windowE, windowP; // Running sums of the last windows fitted by alphaE and alphaP.
+	enum { MAX_RESERVED_STEPS = 65536 };
+
+	bool canContinue(Search<P, pSize, F, fSize, V, vSize> *search) {
+		return search->getCurrentNEvals() < M && !search->isStuck() && !this->isTimeUp();
+	}
 
 	int adjustExp(Search<P, pSize, F, fSize, V, vSize> *search, double r) {
 		int sPrev = s;
@@ -60,7 +109,7 @@ class CSMOn : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
 		if(s-sPrev < 2) return -1;
 		int pB = -1;
 		double alpha1, alpha2;
-		while(search->getCurrentNEvals() < M && !search->isStuck()){
+		while(canContinue(search)){
 			if(decayE() < r && decayL() < r){
 				if(pB == -1){
 					pB = s-2;
@@ -84,7 +133,7 @@ class CSMOn : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
 		if(s-sPrev < 3) return -1;
 		double alpha1 = alphaP(pT, s-1);
 		double alpha2 = alphaP(pT, s);
-		while(alpha2 >= alpha1 && search->getCurrentNEvals() < M && !search->isStuck()){
+		while(alpha2 >= alpha1 && canContinue(search)){
 			if(decayE() >= r || decayL() >= r) return -1;
 			getBest(search, 1);
 			alpha1 = alpha2;
@@ -94,7 +143,8 @@ class CSMOn : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
 	}
 
 	void getBest(Search<P, pSize, F, fSize, V, vSize> *search, int nBest) {
-		for(int i=0; i < nBest && search->getCurrentNEvals() < M && !search->isStuck(); i++){
+		for(int i=0; i < nBest && canContinue(search); i++){
+			this->admitImmigrants(search);
 			search->next(M);
 			gb->push_back(t_point<F>(search->getCurrentNEvals(), search->getBestFitness()->getFirstValue()));
 			s++;
@@ -109,40 +159,25 @@ class CSMOn : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
 		return fabs(1 - ((*gb)[s].y-(*gb)[s-1].y) / ((*gb)[s-1].y-(*gb)[s-2].y));
 	}
 
+	/**
+	 * The windows fitted always grow from the same first point (a new window starts only when
+	 * the first point changes), so the running sums are extended with the new points only,
+	 * making every fit O(1) amortized.
+	 */
 	double alphaE(int p1, int p2) {
-		int i, n = p2 - p1 + 1;
-		double yAvg = 0, yAvgLn, ySumLn = 0, xSum = 0, xAvg, S1 = 0, S2 = 0, aux;
-		for(i=p1; i <= p2; i++){
-			xSum += (*gb)[i].x;
-			yAvg += (*gb)[i].y;
-			ySumLn += log((*gb)[i].y);
+		if(windowE.first != p1 || windowE.last > p2) windowE.reset(p1, (*gb)[p1].x, (*gb)[p1].y);
+		for(int i=windowE.last+1; i <= p2; i++){
+			windowE.add((*gb)[i].x, (*gb)[i].y, (*gb)[i].lnY);
 		}
-		xAvg = xSum / n;
-		yAvg /= n;
-		yAvgLn = ySumLn / n;
-		for(i=p1; i <= p2; i++){
-			aux = ((*gb)[i].x - xAvg);
-			S1 += aux * ((*gb)[i].y - yAvgLn);
-			S2 += aux * aux;
-		}
-		return (ySumLn - (S1 / S2) * xSum) / n;
+		return windowE.intercept();
 	}
 
 	double alphaP(int p1, int p2) {
-		int i, n = p2 - p1 + 1;
-		double yAvgLog, ySumLog = 0, xAvgLog, xSumLog = 0, S1 = 0, S2 = 0, aux;
-		for(i=p1; i <= p2; i++){
-			xSumLog += log10((*gb)[i].x);
-			ySumLog += log10((*gb)[i].y);
-		}
-		xAvgLog = xSumLog / n;
-		yAvgLog = ySumLog / n;
-		for(i=p1; i <= p2; i++){
-			aux = (log10((*gb)[i].x) - xAvgLog);
-			S1 += aux * (log10((*gb)[i].y) - yAvgLog);
-			S2 += aux * aux;
+		if(windowP.first != p1 || windowP.last > p2) windowP.reset(p1, (*gb)[p1].log10X, (*gb)[p1].log10Y);
+		for(int i=windowP.last+1; i <= p2; i++){
+			windowP.add((*gb)[i].log10X, (*gb)[i].log10Y, (*gb)[i].log10Y);
 		}
-		return (ySumLog - (S1 / S2) * xSumLog) / n;
+		return windowP.intercept();
 	}
 
 public:
@@ -159,7 +194,11 @@ public:
 		this->R = R;
 		this->minEstimatedFit = minEstimatedFit;
 		gb = new vector<t_point<F>>();
+		// Every step spends at least one evaluation, so (up to the cap) the history never grows during the runs.
+		gb->reserve(min(this->M, (int)MAX_RESERVED_STEPS));
 		s = -1;
+		windowE.reset(-1, 0, 0);
+		windowP.reset(-1, 0, 0);
 	}
 	~CSMOn() {
 		delete gb;
@@ -174,6 +213,9 @@ public:
 	void run(Search<P, pSize, F, fSize, V, vSize> *search) {
 		s = -1;
 		gb->clear();
+		windowE.reset(-1, 0, 0);
+		windowP.reset(-1, 0, 0);
+		search->setDeadline(this->getDeadline());
 		search->startup();
 
 		int pT = -1, pS = -1;
@@ -185,7 +227,7 @@ public:
 				pT = adjustExp(search, r);
 			if(pT > 0)
 				pS = adjustLog(search, r, pT);
-		}while(search->getCurrentNEvals() < M && (r > R || pS == -1) && !search->isStuck());
+		}while((r > R || pS == -1) && canContinue(search));
 
 		search->finalize();
 	}
@@ -0,0 +1,282 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file CachedFitnessPolicy.h
+ * @class CachedFitnessPolicy
+ * @author Peter Frank Perroni
+ * @brief FitnessPolicy decorator that memoizes the fitness of the Solutions already evaluated.
+ * @details Duplicate evaluations are common in TH (e.g. individuals reset over the bias, or
+ *          candidates reverted by the local search). This policy keeps a bounded cache
+ *          (hash of the positions -> fitness and constraint violations) in front of any
+ *          FitnessPolicy, and only calls the wrapped policy on cache misses.
+ *
+ *          The positions can be quantized before hashing, so that nearly identical Solutions
+ *          share the same entry (the cached fitness is then the one of the first Solution
+ *          evaluated within the same quantum). With quantum zero, only exact matches hit.
+ *
+ *          The cache is direct-mapped: every key has a single slot, and a newer entry
+ *          replaces an older one colliding in the same slot.
+ *
+ *          The incremental updates of {@link applyDelta()} (e.g. the HillClimbing moves)
+ *          are forwarded to the wrapped policy without going through the cache.
+ */
+
+#ifndef CACHEDFITNESSPOLICY_H_
+#define CACHEDFITNESSPOLICY_H_
+
+#include "FitnessPolicy.h"
+
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class CachedFitnessPolicy : public FitnessPolicy<P, pSize, F, fSize, V, vSize> {
+	FitnessPolicy<P, pSize, F, fSize, V, vSize> *fitnessPolicy;
+	int n, capacity, keySize;
+	double quantum;
+	P *keys;
+	F *fitnessValues;
+	V *violationValues;
+	uint64_t *hashes;
+	bool *used;
+	long long hits, misses;
+	std::mutex lock, batchLock;
+	std::vector<uint64_t> batchHashes, pendingHashes; // Reused across the batches, grown to the largest one.
+	std::vector<Solution<P, pSize, F, fSize, V, vSize>*> pending;
+
+	inline P quantize(P value) {
+		if(quantum > 0) value = (P)(std::floor(value / quantum + 0.5) * quantum);
+		return (value == 0) ? (P)0 : value; // Both zeros share the same key.
+	}
+
+	uint64_t hash(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		if(solution->getNDimensions() != n) {
+			throw std::invalid_argument("The number of dimensions of the Solution is not compatible with the cache.");
+		}
+		std::hash<P> hasher;
+		uint64_t h = 0xCBF29CE484222325ULL;
+		Position<P, pSize> *positions = solution->getInternalPositions();
+		for(int i=0; i < n; i++){
+			for(int j=0; j < pSize; j++){
+				h = (h ^ (uint64_t)hasher(quantize(positions[i].getInternalPosition(j)))) * 0x100000001B3ULL;
+			}
+		}
+		return h ^ (h >> 32);
+	}
+
+	bool matches(int slot, Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		P *key = &keys[(long)slot * keySize];
+		Position<P, pSize> *positions = solution->getInternalPositions();
+		for(int i=0, k=0; i < n; i++){
+			for(int j=0; j < pSize; j++, k++){
+				if(key[k] != quantize(positions[i].getInternalPosition(j))) return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Copy the cached fitness to the Solution, if any (the lock must be held).
+	 * @return True on a cache hit.
+	 */
+	bool lookup(Solution<P, pSize, F, fSize, V, vSize> *solution, uint64_t h) {
+		int slot = (int)(h % capacity);
+		if(!used[slot] || hashes[slot] != h || !matches(slot, solution)) {
+			misses++;
+			return false;
+		}
+		solution->setFitness(&fitnessValues[(long)slot * fSize]);
+		solution->setViolation(&violationValues[(long)slot * vSize]);
+		hits++;
+		return true;
+	}
+
+	/**
+	 * @brief Store the fitness of an evaluated Solution (the lock must be held).
+	 */
+	void store(Solution<P, pSize, F, fSize, V, vSize> *solution, uint64_t h) {
+		int slot = (int)(h % capacity);
+		P *key = &keys[(long)slot * keySize];
+		Position<P, pSize> *positions = solution->getInternalPositions();
+		for(int i=0, k=0; i < n; i++){
+			for(int j=0; j < pSize; j++, k++){
+				key[k] = quantize(positions[i].getInternalPosition(j));
+			}
+		}
+		solution->getFitness(&fitnessValues[(long)slot * fSize]);
+		solution->getViolation(&violationValues[(long)slot * vSize]);
+		hashes[slot] = h;
+		used[slot] = true;
+	}
+
+public:
+	/**
+	 * @brief Constructor to wrap a FitnessPolicy with a cache.
+	 *
+	 * The wrapped policy is not owned by the cache, and must outlive it.
+	 *
+	 * @param fitnessPolicy The FitnessPolicy that actually evaluates the Solutions.
+	 * @param nDimensions The number of dimensions of the Solutions evaluated.
+	 * @param capacity The maximum number of Solutions cached.
+	 * @param quantum The quantization step applied to the positions before hashing (zero for exact matches).
+	 */
+	CachedFitnessPolicy(FitnessPolicy<P, pSize, F, fSize, V, vSize> *fitnessPolicy, int nDimensions, int capacity, double quantum = 0) {
+		if(fitnessPolicy == NULL) throw std::invalid_argument("The fitness policy must be provided.");
+		if(nDimensions <= 0) throw std::invalid_argument("The number of dimensions must be greater than zero.");
+		if(capacity <= 0) throw std::invalid_argument("The cache capacity must be greater than zero.");
+		if(quantum < 0) throw std::invalid_argument("The quantum cannot be negative.");
+		this->fitnessPolicy = fitnessPolicy;
+		this->n = nDimensions;
+		this->capacity = capacity;
+		this->quantum = quantum;
+		keySize = n * pSize;
+		keys = new P[(long)capacity * keySize];
+		fitnessValues = new F[(long)capacity * fSize];
+		violationValues = new V[(long)capacity * vSize];
+		hashes = new uint64_t[capacity];
+		used = new bool[capacity];
+		clear();
+	}
+	~CachedFitnessPolicy() {
+		delete[] keys;
+		delete[] fitnessValues;
+		delete[] violationValues;
+		delete[] hashes;
+		delete[] used;
+	}
+
+	/**
+	 * @brief Evaluate the Solution, unless its fitness is already cached.
+	 */
+	void apply(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		uint64_t h = hash(solution);
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if(lookup(solution, h)) return;
+		}
+		fitnessPolicy->apply(solution);
+		std::lock_guard<std::mutex> guard(lock);
+		store(solution, h);
+	}
+
+	/**
+	 * @brief Update the fitness through the wrapped policy, bypassing the cache.
+	 *
+	 * Looking up the cache requires hashing all the positions, which would turn an O(k) delta
+	 * evaluation back into O(n). The updated Solution is therefore neither looked up nor stored.
+	 */
+	void applyDelta(Solution<P, pSize, F, fSize, V, vSize> *solution, int *changedDims, P *oldValues, int k) {
+		fitnessPolicy->applyDelta(solution, changedDims, oldValues, k);
+	}
+
+	/**
+	 * @brief Evaluate the Solutions whose fitness is not cached, as a single batch of the wrapped policy.
+	 */
+	void applyBatch(Solution<P, pSize, F, fSize, V, vSize> **solutions, int count) {
+		if(solutions == NULL || count <= 0) return;
+		std::lock_guard<std::mutex> batchGuard(batchLock); // The batch buffers are shared by the callers.
+		if((int)batchHashes.size() < count) batchHashes.resize(count);
+		pending.clear();
+		pendingHashes.clear();
+		for(int i=0; i < count; i++) batchHashes[i] = hash(solutions[i]);
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			for(int i=0; i < count; i++){
+				if(!lookup(solutions[i], batchHashes[i])) {
+					pending.push_back(solutions[i]);
+					pendingHashes.push_back(batchHashes[i]);
+				}
+			}
+		}
+		if(pending.empty()) return;
+		fitnessPolicy->setThreadPool(this->getThreadPool());
+		fitnessPolicy->applyBatch(pending.data(), (int)pending.size());
+		std::lock_guard<std::mutex> guard(lock);
+		for(size_t i=0; i < pending.size(); i++){
+			store(pending[i], pendingHashes[i]);
+		}
+	}
+
+	/**
+	 * @brief Remove all entries from the cache and reset the statistics.
+	 */
+	void clear() {
+		std::lock_guard<std::mutex> guard(lock);
+		for(int i=0; i < capacity; i++) used[i] = false;
+		hits = misses = 0;
+	}
+
+	long long getHits() {
+		std::lock_guard<std::mutex> guard(lock);
+		return hits;
+	}
+
+	long long getMisses() {
+		std::lock_guard<std::mutex> guard(lock);
+		return misses;
+	}
+
+	/**
+	 * @brief Get the fraction of the evaluations answered by the cache.
+	 * @return The hit rate in [0, 1] (zero if nothing was evaluated yet).
+	 */
+	double getHitRate() {
+		std::lock_guard<std::mutex> guard(lock);
+		return (hits + misses > 0) ? (double)hits / (hits + misses) : 0;
+	}
+
+	FitnessPolicy<P, pSize, F, fSize, V, vSize>* getFitnessPolicy() {
+		return fitnessPolicy;
+	}
+
+	bool firstIsBetter(Solution<P, pSize, F, fSize, V, vSize> *first, Solution<P, pSize, F, fSize, V, vSize> *second) {
+		return fitnessPolicy->firstIsBetter(first, second);
+	}
+
+	bool firstIsBetter(Fitness<F, fSize> *first, Fitness<F, fSize> *second) {
+		return fitnessPolicy->firstIsBetter(first, second);
+	}
+
+	void setWorstFitness(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		fitnessPolicy->setWorstFitness(solution);
+	}
+
+	void setWorstFitness(Fitness<F, fSize> *fitness) {
+		fitnessPolicy->setWorstFitness(fitness);
+	}
+
+	void setBestFitness(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		fitnessPolicy->setBestFitness(solution);
+	}
+
+	void setBestFitness(Fitness<F, fSize> *fitness) {
+		fitnessPolicy->setBestFitness(fitness);
+	}
+
+	double getMinEstimatedFitnessValue() {
+		return fitnessPolicy->getMinEstimatedFitnessValue();
+	}
+};
+
+#endif /* CACHEDFITNESSPOLICY_H_ */
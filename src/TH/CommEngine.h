@@ -0,0 +1,1299 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file CommEngine.h
+ * @class CommEngine
+ * @author Peter Frank Perroni
+ * @brief Event-driven communication engine for the parent/children exchanges of a TH instance.
+ * @details Every exchange (in both directions) is a single message, whose wire format is:
+ *          - Header: the sender's status and the number of dimensions;
+ *          - The Solution's positions (nDimensions * pSize elements of type P);
+ *          - The Solution's fitness (fSize elements of type F);
+ *          - The Solution's constraint violation (vSize elements of type V).
+ *
+ *          With the default codec (EXCHANGE_CODEC_RAW), the message is described by an MPI derived
+ *          datatype over one contiguous packet buffer, so MPI still performs any type conversion
+ *          required between heterogeneous nodes.
+ *
+ *          The other codecs reduce the traffic of large Solutions, sending variable-sized byte packets
+ *          (so all nodes must share the same data representation):
+ *          - EXCHANGE_CODEC_FP32: the positions are sent as 32-bit floats (lossy);
+ *          - EXCHANGE_CODEC_DELTA: only the positions that changed since the last Solution sent
+ *            to the same peer are sent, as (index, value) pairs (lossless). If most positions
+ *            changed, the positions are sent in full.
+ *
+ *          With both codecs, a Solution identical to the last one sent to the same peer is not sent
+ *          again, and the fitness and violation are always sent in full. Sends can be requested
+ *          as lossless (e.g. the final result sent to the parent), which disables the FP32 conversion.
+ *
+ *          All channels are created once as MPI persistent requests, one per peer and direction.
+ *          Every inbound channel works as a single-slot mailbox: a receive is always posted,
+ *          and whenever it completes the receive is restarted, so only the most recent Solution
+ *          sent by every peer is kept. The inbound channels are double buffered: two Solutions
+ *          are used alternately as the receive buffer and as the peer's inbox, so the data
+ *          received never needs to be copied to the inbox (with the raw codec, MPI writes it
+ *          straight into the Solution's storage).
+ *          All inbound channels (from children and from parent) are progressed together
+ *          through MPI_Testsome (non-blocking) or MPI_Waitsome (blocking, without polling).
+ *
+ *          Outbound channels never queue data: if the previous send to a peer is still
+ *          in progress, the new Solution is simply not sent (the peer will receive
+ *          a newer one later).
+ *
+ *          Optionally (see {@link startThread()}), a communication thread performs all MPI calls
+ *          during the search phase, continuously draining the inbound channels and posting the
+ *          outbound ones. It exchanges the Solutions with the search thread through lock-free
+ *          single-slot mailboxes (see Mailbox.h), so the public interface remains the same.
+ *          This mode requires MPI_THREAD_SERIALIZED support.
+ *
+ *          Optionally, the peers in the same host exchange the Solutions through shared memory
+ *          (MPI_Win_allocate_shared) instead of messages. Every TH instance owns one slot per
+ *          same-host peer, where it publishes the last Solution sent to that peer (always in full,
+ *          with the raw layout) under a sequence lock: the writer never waits, and the reader copies
+ *          the Solution straight from the slot into its inbox, retrying at the next poll if it
+ *          was overwritten meanwhile. There is no message matching nor any intermediate buffer,
+ *          and, as with the messages, only the most recent Solution is kept. Since these channels
+ *          do not complete MPI requests, the blocking waits poll them (pausing
+ *          COMM_THREAD_IDLE_MICROSECONDS between polls) while any of them is active.
+ *
+ *          Child status values: 0 (not heard yet), 1 (searching), -1 (residual communication
+ *          phase) and -2 (finished).
+ */
+
+#ifndef COMMENGINE_H_
+#define COMMENGINE_H_
+
+#include "macros.h"
+#include "config.h"
+#include "Solution.h"
+#include "MpiTypeTraits.h"
+#include "Mailbox.h"
+
+#include <mpi.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class CommEngine {
+	/**
+	 * @brief Header of every packet.
+	 */
+	struct PacketHeader {
+		int status;
+		int nDimensions;
+		int encoding;
+		int count;
+	};
+
+	/**
+	 * @brief Inbound channel, with two Solutions used alternately as the receive buffer and the inbox.
+	 */
+	struct Inbound {
+		Solution<P, pSize, F, fSize, V, vSize> *slots[2];
+		PacketHeader headers[2];	// Raw codec only.
+		MPI_Datatype slotTypes[2];	// Raw codec only.
+		MPI_Request requests[2];	// One persistent receive per slot (raw codec), or for the packet (other codecs).
+		char *packet;				// Encoded codecs only.
+		P *reference;				// Encoded codecs only.
+		int latest;					// The slot holding the latest Solution received.
+		char *shared;				// The peer's shared-memory slot, or NULL if the channel uses messages.
+		unsigned sequence;			// Sequence of the last Solution read from the shared-memory slot.
+		bool sharedActive;			// True while the shared-memory slot is being polled.
+	};
+
+	/**
+	 * @brief Message exchanged between the search thread and the communication thread.
+	 */
+	struct Envelope {
+		Solution<P, pSize, F, fSize, V, vSize> *solution;
+		int status;
+		bool lossless;
+
+		Envelope(int n) {
+			solution = new Solution<P, pSize, F, fSize, V, vSize>(n);
+			status = 0;
+			lossless = false;
+		}
+		~Envelope() {
+			delete solution;
+		}
+	};
+
+	// How the positions are encoded in a packet.
+	static const int ENCODING_FULL = 0;
+	static const int ENCODING_FP32 = 1;
+	static const int ENCODING_DELTA = 2;
+
+	MPI_Comm comm;
+	int ID;
+	int n;
+	int parent;
+	int nChildren;
+	int *children;
+	int codec;
+
+	// Packet layout (byte offsets of every section in the packet buffer).
+	MPI_Datatype packetType;
+	size_t packetSize, positionsOffset, fitnessOffset, violationOffset;
+	P *scratch;
+
+	// Inbound requests: one per child, followed by one for the parent, followed by the finalization signal.
+	MPI_Request *recvRequests;
+	bool *recvActive;
+	int *completedIndices;
+	int nRecvRequests;
+	int parentIndex;
+	int finalizeIndex;
+
+	// Up-links from the children.
+	Inbound *childInbound;
+	int *childLinkStatus;	// Last status received (owned by the thread performing the MPI calls).
+	int *childStatus;		// Last status delivered to the search thread.
+	bool *childHasNew;
+	bool *childPeeked;
+	Solution<P, pSize, F, fSize, V, vSize> **childCurrent;
+
+	// Down-links to the children.
+	MPI_Request *childSendRequests;
+	char **childSendPackets;
+	P **childSendReference;
+	bool *childSendActive;
+
+	// Down-link from the parent.
+	Inbound parentInbound;
+	bool parentHasNew;
+	bool parentPeeked;
+	Solution<P, pSize, F, fSize, V, vSize> *parentCurrent;
+	bool discardParentData;
+
+	// Up-link to the parent.
+	MPI_Request parentSendRequest;
+	char *parentSendPacket;
+	P *parentSendReference;
+	bool parentSendActive;
+
+	int finalizeSignal;
+	bool finalized;
+
+	// Shared-memory transport (peers in the same host).
+	MPI_Comm hostComm;
+	MPI_Win sharedWindow;
+	size_t sharedHeaderOffset, sharedPositionsOffset, sharedFitnessOffset, sharedViolationOffset, sharedSlotSize;
+	char **childSendShared;	// Slot written for every child (NULL if the child uses messages).
+	char *parentSendShared;	// Slot written for the parent (NULL if the parent uses messages).
+	int nSharedInbound;
+
+	// Communication thread.
+	std::thread *commThread;
+	std::atomic<bool> stopRequested;
+	bool useMailboxes;	// Set only while the communication thread is not running.
+	Mailbox<Envelope> **childInMail, **childOutMail, *parentInMail, *parentOutMail;
+	Envelope **childPending, *parentPending;
+
+	void check(int rc, const char *operation, int peer) {
+		if(rc != MPI_SUCCESS) {
+			DEBUG_TEXT("TH[%i] error %s TH[%i].\n", ID, operation, peer);
+			DEBUG2FILE_TEXT(ID, "TH[%i] error %s TH[%i].\n", ID, operation, peer);
+			exit(1);
+		}
+	}
+
+	static size_t alignUp(size_t offset, size_t alignment) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	/**
+	 * @brief Calculate the packet layout and create the MPI datatype describing it.
+	 *
+	 * Raw packets contain the header, positions, fitness and violation, in this order.
+	 * Encoded packets contain the header, fitness, violation and the encoded positions, in this order.
+	 */
+	void createPacketType() {
+		packetType = MPI_DATATYPE_NULL;
+		if(codec == EXCHANGE_CODEC_RAW) {
+			positionsOffset = alignUp(sizeof(PacketHeader), alignof(P));
+			fitnessOffset = alignUp(positionsOffset + n * pSize * sizeof(P), alignof(F));
+			violationOffset = alignUp(fitnessOffset + fSize * sizeof(F), alignof(V));
+			packetSize = alignUp(violationOffset + vSize * sizeof(V), alignof(PacketHeader));
+
+			int lengths[4] = {4, n * pSize, fSize, vSize};
+			MPI_Aint displacements[4] = {0, (MPI_Aint)positionsOffset, (MPI_Aint)fitnessOffset, (MPI_Aint)violationOffset};
+			MPI_Datatype types[4] = {MPI_INT, MpiTypeTraits<P>::GetType(), MpiTypeTraits<F>::GetType(), MpiTypeTraits<V>::GetType()};
+			MPI_Datatype structType;
+			check(MPI_Type_create_struct(4, lengths, displacements, types, &structType), "creating the packet datatype for", ID);
+			check(MPI_Type_create_resized(structType, 0, (MPI_Aint)packetSize, &packetType), "creating the packet datatype for", ID);
+			check(MPI_Type_commit(&packetType), "creating the packet datatype for", ID);
+			MPI_Type_free(&structType);
+		}
+		else {
+			fitnessOffset = alignUp(sizeof(PacketHeader), alignof(F));
+			violationOffset = alignUp(fitnessOffset + fSize * sizeof(F), alignof(V));
+			positionsOffset = alignUp(violationOffset + vSize * sizeof(V), 16);
+			// The delta encoding is used only when it is smaller than the full positions.
+			size_t maxPayload = n * pSize * (sizeof(P) > sizeof(float) ? sizeof(P) : sizeof(float)) + 16;
+			packetSize = positionsOffset + maxPayload;
+		}
+	}
+
+	template <class T>
+	static bool sameValues(const T *a, const T *b, int size) {
+		for(int k=0; k < size; k++) {
+			if(a[k] != b[k]) return false;
+		}
+		return true;
+	}
+
+	char* newPacket() {
+		char *packet = new char[packetSize];
+		memset(packet, 0, packetSize);
+		return packet;
+	}
+
+	P* newReference() {
+		P *reference = new P[n * pSize];
+		for(int k=0; k < n * pSize; k++) reference[k] = P();
+		return reference;
+	}
+
+	/**
+	 * @brief Serialize a Solution and the sender's status into a raw packet.
+	 */
+	void pack(Solution<P, pSize, F, fSize, V, vSize> *solution, int status, char *packet) {
+		PacketHeader *header = (PacketHeader*)packet;
+		header->status = status;
+		header->nDimensions = n;
+		header->encoding = ENCODING_FULL;
+		header->count = n * pSize;
+		solution->getPositions((P*)(packet + positionsOffset));
+		solution->getFitness((F*)(packet + fitnessOffset));
+		solution->getViolation((V*)(packet + violationOffset));
+	}
+
+	/**
+	 * @brief Serialize a Solution and the sender's status into an encoded packet.
+	 *
+	 * The packet must still contain the last packet sent to the same peer,
+	 * and the reference must contain the last positions sent to the same peer.
+	 * The reference is updated with the positions of the Solution.
+	 *
+	 * @return The packet size (in bytes), or zero if the Solution is identical to the last one sent.
+	 */
+	int encode(Solution<P, pSize, F, fSize, V, vSize> *solution, int status, char *packet, P *reference, bool lossless) {
+		PacketHeader *header = (PacketHeader*)packet;
+		F *fitness = (F*)(packet + fitnessOffset);
+		V *violation = (V*)(packet + violationOffset);
+		const int size = n * pSize;
+
+		F currFitness[fSize];
+		V currViolation[vSize];
+		solution->getPositions(scratch);
+		solution->getFitness(currFitness);
+		solution->getViolation(currViolation);
+		int nChanged = 0;
+		for(int k=0; k < size; k++) {
+			if(scratch[k] != reference[k]) nChanged++;
+		}
+		if(nChanged == 0 && !lossless && header->nDimensions == n && header->status == status
+				&& sameValues(currFitness, fitness, fSize) && sameValues(currViolation, violation, vSize)) {
+			return 0;
+		}
+
+		header->status = status;
+		header->nDimensions = n;
+		COPY_ARR(currFitness, fitness, fSize);
+		COPY_ARR(currViolation, violation, vSize);
+		char *payload = packet + positionsOffset;
+		size_t payloadSize;
+		if(codec == EXCHANGE_CODEC_FP32 && !lossless) {
+			float *values = (float*)payload;
+			for(int k=0; k < size; k++) values[k] = (float)scratch[k];
+			header->encoding = ENCODING_FP32;
+			header->count = size;
+			payloadSize = size * sizeof(float);
+		}
+		else if(codec == EXCHANGE_CODEC_DELTA && nChanged * (sizeof(int) + sizeof(P)) < size * sizeof(P)) {
+			int *indices = (int*)payload;
+			P *values = (P*)(payload + alignUp(nChanged * sizeof(int), alignof(P)));
+			for(int k=0, j=0; k < size; k++) {
+				if(scratch[k] != reference[k]) {
+					indices[j] = k;
+					values[j++] = scratch[k];
+				}
+			}
+			header->encoding = ENCODING_DELTA;
+			header->count = nChanged;
+			payloadSize = alignUp(nChanged * sizeof(int), alignof(P)) + nChanged * sizeof(P);
+		}
+		else {
+			memcpy(payload, scratch, size * sizeof(P));
+			header->encoding = ENCODING_FULL;
+			header->count = size;
+			payloadSize = size * sizeof(P);
+		}
+		memcpy(reference, scratch, size * sizeof(P));
+		return (int)(positionsOffset + payloadSize);
+	}
+
+	/**
+	 * @brief Deserialize an encoded packet into a Solution.
+	 *
+	 * The reference must contain the last positions received from the same peer,
+	 * and it is updated with the positions received.
+	 *
+	 * @return The sender's status.
+	 */
+	int decode(char *packet, P *reference, Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		PacketHeader *header = (PacketHeader*)packet;
+		char *payload = packet + positionsOffset;
+		if(header->encoding == ENCODING_FP32) {
+			float *values = (float*)payload;
+			for(int k=0; k < header->count; k++) reference[k] = (P)values[k];
+		}
+		else if(header->encoding == ENCODING_DELTA) {
+			int *indices = (int*)payload;
+			P *values = (P*)(payload + alignUp(header->count * sizeof(int), alignof(P)));
+			for(int j=0; j < header->count; j++) reference[indices[j]] = values[j];
+		}
+		else {
+			memcpy(reference, payload, header->count * sizeof(P));
+		}
+		*solution = reference;
+		solution->setFitness((F*)(packet + fitnessOffset));
+		solution->setViolation((V*)(packet + violationOffset));
+		return header->status;
+	}
+
+	/**
+	 * @brief Start sending a packet previously built to a peer.
+	 */
+	void post(char *packet, int size, int peer, int tag, MPI_Request *request) {
+		if(codec == EXCHANGE_CODEC_RAW) {
+			check(MPI_Start(request), "sending to", peer);
+		}
+		else {
+			check(MPI_Isend(packet, size, MPI_BYTE, peer, tag, comm, request), "sending to", peer);
+		}
+	}
+
+	/**
+	 * @brief Create the shared-memory window with one slot per peer in the same host.
+	 *
+	 * Every TH instance's segment starts with a directory (the number of slots and the peer ID of every slot),
+	 * followed by the slots. Every slot holds the sequence lock, followed by the packet header, positions,
+	 * fitness and violation (the raw layout), and it is written only by the segment's owner.
+	 * This is a collective operation over the TH instances of the same host.
+	 */
+	void createSharedWindow() {
+		sharedHeaderOffset = alignUp(sizeof(std::atomic<unsigned>), alignof(PacketHeader));
+		sharedPositionsOffset = alignUp(sharedHeaderOffset + sizeof(PacketHeader), alignof(P));
+		sharedFitnessOffset = alignUp(sharedPositionsOffset + n * pSize * sizeof(P), alignof(F));
+		sharedViolationOffset = alignUp(sharedFitnessOffset + fSize * sizeof(F), alignof(V));
+		sharedSlotSize = alignUp(sharedViolationOffset + vSize * sizeof(V), TH_MEMORY_ALIGNMENT);
+
+		// Find the peers in the same host (the parent is the last peer).
+		int nPeers = nChildren + (hasParent() ? 1 : 0);
+		int *peers = new int[nPeers + 1];
+		int *hostRanks = new int[nPeers + 1];
+		for(int i=0; i < nChildren; i++) peers[i] = children[i];
+		if(hasParent()) peers[nChildren] = parent;
+		MPI_Group group, hostGroup;
+		check(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, ID, MPI_INFO_NULL, &hostComm), "splitting the host communicator for", ID);
+		MPI_Comm_group(comm, &group);
+		MPI_Comm_group(hostComm, &hostGroup);
+		MPI_Group_translate_ranks(group, nPeers, peers, hostGroup, hostRanks);
+		MPI_Group_free(&group);
+		MPI_Group_free(&hostGroup);
+		int nSlots = 0;
+		for(int i=0; i < nPeers; i++) {
+			if(hostRanks[i] != MPI_UNDEFINED) nSlots++;
+		}
+
+		// Allocate this TH instance's segment and fill its directory.
+		size_t directorySize = alignUp((nSlots + 1) * sizeof(int), TH_MEMORY_ALIGNMENT);
+		char *segment;
+		check(MPI_Win_allocate_shared((MPI_Aint)(directorySize + nSlots * sharedSlotSize), 1, MPI_INFO_NULL,
+				hostComm, &segment, &sharedWindow), "allocating the shared-memory window for", ID);
+		check(MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedWindow), "locking the shared-memory window for", ID);
+		int *directory = (int*)segment;
+		directory[0] = nSlots;
+		for(int i=0, slot=0; i < nPeers; i++) {
+			if(hostRanks[i] == MPI_UNDEFINED) continue;
+			directory[1 + slot] = peers[i];
+			char *data = segment + directorySize + slot * sharedSlotSize;
+			memset(data, 0, sharedSlotSize);
+			new (data) std::atomic<unsigned>(0);
+			if(i < nChildren) childSendShared[i] = data;
+			else parentSendShared = data;
+			slot++;
+		}
+		MPI_Win_sync(sharedWindow);
+		MPI_Barrier(hostComm);
+		MPI_Win_sync(sharedWindow);
+
+		// Find the slot every same-host peer writes for this TH instance.
+		for(int i=0; i < nPeers; i++) {
+			if(hostRanks[i] == MPI_UNDEFINED) continue;
+			MPI_Aint size;
+			int dispUnit;
+			char *peerSegment;
+			check(MPI_Win_shared_query(sharedWindow, hostRanks[i], &size, &dispUnit, &peerSegment), "querying the shared-memory window of", peers[i]);
+			int *peerDirectory = (int*)peerSegment;
+			size_t peerDirectorySize = alignUp((peerDirectory[0] + 1) * sizeof(int), TH_MEMORY_ALIGNMENT);
+			for(int slot=0; slot < peerDirectory[0]; slot++) {
+				if(peerDirectory[1 + slot] != ID) continue;
+				Inbound &inbound = (i < nChildren) ? childInbound[i] : parentInbound;
+				inbound.shared = peerSegment + peerDirectorySize + slot * sharedSlotSize;
+				nSharedInbound++;
+				break;
+			}
+		}
+		delete[] peers;
+		delete[] hostRanks;
+	}
+
+	void freeSharedWindow() {
+		if(sharedWindow == MPI_WIN_NULL) return;
+		MPI_Win_unlock_all(sharedWindow);
+		MPI_Win_free(&sharedWindow);
+		MPI_Comm_free(&hostComm);
+	}
+
+	/**
+	 * @brief Publish a Solution and the sender's status into a shared-memory slot (never blocks).
+	 */
+	void writeShared(char *slot, Solution<P, pSize, F, fSize, V, vSize> *solution, int status) {
+		std::atomic<unsigned> *sequence = (std::atomic<unsigned>*)slot;
+		unsigned current = sequence->load(std::memory_order_relaxed);
+		sequence->store(current + 1, std::memory_order_relaxed); // Odd: being written.
+		std::atomic_thread_fence(std::memory_order_release);
+		PacketHeader *header = (PacketHeader*)(slot + sharedHeaderOffset);
+		header->status = status;
+		header->nDimensions = n;
+		header->encoding = ENCODING_FULL;
+		header->count = n * pSize;
+		solution->getPositions((P*)(slot + sharedPositionsOffset));
+		solution->getFitness((F*)(slot + sharedFitnessOffset));
+		solution->getViolation((V*)(slot + sharedViolationOffset));
+		sequence->store(current + 2, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Copy a new Solution from the peer's shared-memory slot into the slot of the inbound channel
+	 *        that does not hold the latest Solution.
+	 * @return False if there is no new Solution, or if it was overwritten while being copied.
+	 */
+	bool readShared(Inbound &inbound) {
+		std::atomic<unsigned> *sequence = (std::atomic<unsigned>*)inbound.shared;
+		unsigned current = sequence->load(std::memory_order_acquire);
+		if((current & 1) != 0 || current == inbound.sequence) return false;
+		int k = 1 - inbound.latest;
+		memcpy(&inbound.headers[k], inbound.shared + sharedHeaderOffset, sizeof(PacketHeader));
+		*inbound.slots[k] = (P*)(inbound.shared + sharedPositionsOffset);
+		inbound.slots[k]->setFitness((F*)(inbound.shared + sharedFitnessOffset));
+		inbound.slots[k]->setViolation((V*)(inbound.shared + sharedViolationOffset));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(sequence->load(std::memory_order_relaxed) != current) return false;
+		inbound.sequence = current;
+		inbound.sharedActive = false;
+		return true;
+	}
+
+	/**
+	 * @brief Progress the shared-memory inbound channels.
+	 * @return The number of Solutions received.
+	 */
+	int pollShared() {
+		if(nSharedInbound == 0) return 0;
+		int total = 0;
+		for(int i=0; i < nChildren; i++) {
+			if(childInbound[i].sharedActive && readShared(childInbound[i])) {
+				complete(i);
+				total++;
+			}
+		}
+		if(hasParent() && parentInbound.sharedActive && readShared(parentInbound)) {
+			complete(parentIndex);
+			total++;
+		}
+		return total;
+	}
+
+	/**
+	 * @brief Check if any inbound channel can still receive something.
+	 */
+	bool hasActiveInbound() {
+		for(int i=0; i < nRecvRequests; i++) {
+			if(recvActive[i]) return true;
+		}
+		for(int i=0; i < nChildren; i++) {
+			if(childInbound[i].sharedActive) return true;
+		}
+		return hasParent() && parentInbound.sharedActive;
+	}
+
+	/**
+	 * @brief Create the MPI datatype that receives a raw packet straight into the storage of a Solution.
+	 *
+	 * The type signature is the same as the one of {@link packetType}.
+	 */
+	MPI_Datatype createSlotType(Solution<P, pSize, F, fSize, V, vSize> *slot, PacketHeader *header) {
+		MPI_Datatype slotType;
+		int lengths[4] = {4, n * pSize, fSize, vSize};
+		MPI_Aint addresses[4];
+		MPI_Get_address(header, &addresses[0]);
+		MPI_Get_address(slot->getInternalPositions(), &addresses[1]);
+		MPI_Get_address(slot->getFitness()->internalFitness, &addresses[2]);
+		MPI_Get_address(slot->getViolation()->internalViolations, &addresses[3]);
+		MPI_Datatype types[4] = {MPI_INT, MpiTypeTraits<P>::GetType(), MpiTypeTraits<F>::GetType(), MpiTypeTraits<V>::GetType()};
+		check(MPI_Type_create_struct(4, lengths, addresses, types, &slotType), "creating the slot datatype for", ID);
+		check(MPI_Type_commit(&slotType), "creating the slot datatype for", ID);
+		return slotType;
+	}
+
+	void initInbound(Inbound &inbound, int peer, int tag) {
+		inbound.latest = 1;
+		inbound.packet = NULL;
+		inbound.reference = NULL;
+		for(int k=0; k < 2; k++) {
+			inbound.slots[k] = new Solution<P, pSize, F, fSize, V, vSize>(n);
+			memset(&inbound.headers[k], 0, sizeof(PacketHeader));
+			inbound.slotTypes[k] = MPI_DATATYPE_NULL;
+			inbound.requests[k] = MPI_REQUEST_NULL;
+		}
+		if(inbound.shared != NULL) return;
+		if(codec == EXCHANGE_CODEC_RAW) {
+			for(int k=0; k < 2; k++) {
+				inbound.slotTypes[k] = createSlotType(inbound.slots[k], &inbound.headers[k]);
+				MPI_Recv_init(MPI_BOTTOM, 1, inbound.slotTypes[k], peer, tag, comm, &inbound.requests[k]);
+			}
+		}
+		else {
+			inbound.packet = newPacket();
+			inbound.reference = newReference();
+			MPI_Recv_init(inbound.packet, (int)packetSize, MPI_BYTE, peer, tag, comm, &inbound.requests[0]);
+		}
+	}
+
+	/**
+	 * @brief Post the receive of an inbound channel, targeting the slot that does not hold the latest Solution.
+	 */
+	void startInbound(Inbound &inbound, int index, int peer) {
+		if(inbound.shared != NULL) {
+			inbound.sharedActive = true;
+			return;
+		}
+		recvRequests[index] = inbound.requests[codec == EXCHANGE_CODEC_RAW ? 1 - inbound.latest : 0];
+		recvActive[index] = true;
+		check(MPI_Start(&recvRequests[index]), "posting the receive from", peer);
+	}
+
+	/**
+	 * @brief Make the Solution just received the latest one of an inbound channel.
+	 * @return The sender's status.
+	 */
+	int receive(Inbound &inbound) {
+		int slot = 1 - inbound.latest;
+		inbound.latest = slot;
+		if(codec == EXCHANGE_CODEC_RAW || inbound.shared != NULL) return inbound.headers[slot].status;
+		return decode(inbound.packet, inbound.reference, inbound.slots[slot]);
+	}
+
+	void releaseInbound(Inbound &inbound, int index) {
+		if(recvActive[index]) {
+			MPI_Cancel(&recvRequests[index]);
+			MPI_Wait(&recvRequests[index], MPI_STATUS_IGNORE);
+			recvActive[index] = false;
+		}
+		recvRequests[index] = MPI_REQUEST_NULL; // Alias of one of the inbound's requests.
+		for(int k=0; k < 2; k++) {
+			if(inbound.requests[k] != MPI_REQUEST_NULL) MPI_Request_free(&inbound.requests[k]);
+			if(inbound.slotTypes[k] != MPI_DATATYPE_NULL) MPI_Type_free(&inbound.slotTypes[k]);
+		}
+	}
+
+	void deleteInbound(Inbound &inbound) {
+		for(int k=0; k < 2; k++) delete inbound.slots[k];
+		if(inbound.packet != NULL) delete[] inbound.packet;
+		if(inbound.reference != NULL) delete[] inbound.reference;
+	}
+
+	Mailbox<Envelope>* newMailbox() {
+		return new Mailbox<Envelope>(new Envelope(n), new Envelope(n), new Envelope(n));
+	}
+
+	/**
+	 * @brief Hand a Solution received from a child to the search thread.
+	 */
+	void deliverChild(int i, Solution<P, pSize, F, fSize, V, vSize> *solution, int status) {
+		if(useMailboxes) {
+			Envelope *envelope = childInMail[i]->getBack();
+			*envelope->solution = solution;
+			envelope->status = status;
+			childInMail[i]->publish();
+		}
+		else {
+			childCurrent[i] = solution;
+			childStatus[i] = status;
+			childHasNew[i] = true;
+			childPeeked[i] = false;
+		}
+	}
+
+	/**
+	 * @brief Hand a Solution received from the parent to the search thread.
+	 */
+	void deliverParent(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		if(useMailboxes) {
+			*parentInMail->getBack()->solution = solution;
+			parentInMail->publish();
+		}
+		else {
+			parentCurrent = solution;
+			parentHasNew = true;
+			parentPeeked = false;
+		}
+	}
+
+	/**
+	 * @brief Take the Solutions published by the communication thread (search thread only).
+	 * @return True if any Solution has been taken.
+	 */
+	bool collectMailboxes() {
+		if(childInMail == NULL) return false;
+		bool collected = false;
+		Envelope *envelope;
+		for(int i=0; i < nChildren; i++) {
+			if((envelope = childInMail[i]->take()) != NULL) {
+				childCurrent[i] = envelope->solution;
+				childStatus[i] = envelope->status;
+				childHasNew[i] = collected = true;
+				childPeeked[i] = false;
+			}
+		}
+		if(hasParent() && (envelope = parentInMail->take()) != NULL && !discardParentData) {
+			parentCurrent = envelope->solution;
+			parentHasNew = collected = true;
+			parentPeeked = false;
+		}
+		return collected;
+	}
+
+	/**
+	 * @brief Send the last Solutions published by the search thread (communication thread only).
+	 *
+	 * If a previous send to the same peer is still in progress, the Solution is kept pending
+	 * (a newer one replaces it) and sent as soon as the peer becomes available.
+	 *
+	 * @return The number of Solutions sent.
+	 */
+	int forwardOutbound() {
+		int sent = 0;
+		Envelope *envelope;
+		for(int i=0; i < nChildren; i++) {
+			if((envelope = childOutMail[i]->take()) != NULL) childPending[i] = envelope;
+			if(childPending[i] == NULL) continue;
+			if(childLinkStatus[i] < 0) childPending[i] = NULL; // Ignore inactive children.
+			else if(sendToChildNow(i, childPending[i]->solution)) {
+				childPending[i] = NULL;
+				sent++;
+			}
+		}
+		if(hasParent()) {
+			if((envelope = parentOutMail->take()) != NULL) parentPending = envelope;
+			if(parentPending != NULL && sendToParentNow(parentPending->solution, parentPending->status, parentPending->lossless)) {
+				parentPending = NULL;
+				sent++;
+			}
+		}
+		return sent;
+	}
+
+	void commThreadLoop() {
+		while(!stopRequested.load(std::memory_order_acquire)) {
+			if(progress(false) + forwardOutbound() == 0) {
+				std::this_thread::sleep_for(std::chrono::microseconds(COMM_THREAD_IDLE_MICROSECONDS));
+			}
+		}
+		progress(false);
+		forwardOutbound();
+	}
+
+	bool sendToChildNow(int i, Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		if(childSendShared[i] != NULL) {
+			writeShared(childSendShared[i], solution, 0);
+			return true;
+		}
+		int flag = 1;
+		if(childSendActive[i]) {
+			check(MPI_Test(&childSendRequests[i], &flag, MPI_STATUS_IGNORE), "sending to child", children[i]);
+			if(!flag) return false;
+			childSendActive[i] = false;
+		}
+		int size = 0;
+		if(codec == EXCHANGE_CODEC_RAW) pack(solution, 0, childSendPackets[i]);
+		else if((size = encode(solution, 0, childSendPackets[i], childSendReference[i], false)) == 0) return true;
+		post(childSendPackets[i], size, children[i], MSG_PARENT2CHILD, &childSendRequests[i]);
+		childSendActive[i] = true;
+		DEBUG_TEXT("TH[%i] sent a solution to child TH[%i].\n", ID, children[i]);
+		DEBUG2FILE_TEXT(ID, "TH[%i] sent a solution to child TH[%i].\n", ID, children[i]);
+		return true;
+	}
+
+	bool sendToParentNow(Solution<P, pSize, F, fSize, V, vSize> *solution, int status, bool lossless) {
+		if(parentSendShared != NULL) {
+			writeShared(parentSendShared, solution, status);
+			return true;
+		}
+		int flag = 1;
+		if(parentSendActive) {
+			check(MPI_Test(&parentSendRequest, &flag, MPI_STATUS_IGNORE), "sending to parent", parent);
+			if(!flag) return false;
+			parentSendActive = false;
+		}
+		int size = 0;
+		if(codec == EXCHANGE_CODEC_RAW) pack(solution, status, parentSendPacket);
+		else if((size = encode(solution, status, parentSendPacket, parentSendReference, lossless)) == 0) return true;
+		post(parentSendPacket, size, parent, MSG_CHILD2PARENT, &parentSendRequest);
+		parentSendActive = true;
+		DEBUG_TEXT("TH[%i] sent a solution with status [%i] to parent TH[%i].\n", ID, status, parent);
+		DEBUG2FILE_TEXT(ID, "TH[%i] sent a solution with status [%i] to parent TH[%i].\n", ID, status, parent);
+		return true;
+	}
+
+	void startChildRecv(int i) {
+		startInbound(childInbound[i], i, children[i]);
+	}
+
+	void startParentRecv() {
+		startInbound(parentInbound, parentIndex, parent);
+	}
+
+	/**
+	 * @brief Process one completed inbound request.
+	 */
+	void complete(int index) {
+		recvActive[index] = false;
+		if(index < parentIndex) { // Up-link from a child.
+			childLinkStatus[index] = receive(childInbound[index]);
+			deliverChild(index, childInbound[index].slots[childInbound[index].latest], childLinkStatus[index]);
+			DEBUG_TEXT("TH[%i] obtained best value from child TH[%i] whose status is now [%i].\n", ID, children[index], childLinkStatus[index]);
+			DEBUG2FILE_TEXT(ID, "TH[%i] obtained best value from child TH[%i] whose status is now [%i].\n", ID, children[index], childLinkStatus[index]);
+			// A finished child will not send anything else.
+			if(childLinkStatus[index] > -2) startChildRecv(index);
+		}
+		else if(index == parentIndex) { // Down-link from the parent.
+			// Encoded packets are always decoded, keeping the reference positions synchronized with the parent.
+			receive(parentInbound);
+			if(!discardParentData) {
+				deliverParent(parentInbound.slots[parentInbound.latest]);
+				DEBUG_TEXT("TH[%i] received parent's best position from TH[%i].\n", ID, parent);
+				DEBUG2FILE_TEXT(ID, "TH[%i] received parent's best position from TH[%i].\n", ID, parent);
+			}
+			startParentRecv();
+		}
+		else { // Finalization signal.
+			finalized = true;
+			DEBUG_TEXT("TH[%i] received finalization signal from parent TH[%i].\n", ID, parent);
+			DEBUG2FILE_TEXT(ID, "TH[%i] received finalization signal from parent TH[%i].\n", ID, parent);
+		}
+	}
+
+	/**
+	 * @brief Progress all inbound channels.
+	 * @param block If true, wait (without polling) until at least one request completes.
+	 * @return The number of requests completed.
+	 */
+	int progress(bool block) {
+		int outcount, total = pollShared();
+		if(total > 0) block = false;
+		while(true) {
+			if(block && nSharedInbound == 0) {
+				check(MPI_Waitsome(nRecvRequests, recvRequests, &outcount, completedIndices, MPI_STATUSES_IGNORE), "waiting for", ID);
+			}
+			else {
+				check(MPI_Testsome(nRecvRequests, recvRequests, &outcount, completedIndices, MPI_STATUSES_IGNORE), "testing", ID);
+			}
+			if(outcount == MPI_UNDEFINED || outcount == 0) {
+				if(!block || !hasActiveInbound()) break;
+				// The shared-memory channels do not complete any MPI request, so they are polled.
+				std::this_thread::sleep_for(std::chrono::microseconds(COMM_THREAD_IDLE_MICROSECONDS));
+				if((outcount = pollShared()) == 0) continue;
+			}
+			else {
+				for(int k=0; k < outcount; k++) complete(completedIndices[k]);
+			}
+			total += outcount;
+			block = false; // Once something has arrived, only drain what is already available.
+		}
+		return total;
+	}
+
+public:
+	/**
+	 * @brief Constructor to create the communication engine of a TH instance.
+	 * @param comm The MPI communicator.
+	 * @param ID The TH instance's ID.
+	 * @param parent The parent's ID, or a negative value if there is no parent.
+	 * @param children The children's IDs.
+	 * @param nChildren The number of children.
+	 * @param nDimensions The number of dimensions of the Solutions exchanged.
+	 * @param codec The codec used to exchange the Solutions: EXCHANGE_CODEC_RAW (default),
+	 *        EXCHANGE_CODEC_FP32 or EXCHANGE_CODEC_DELTA (see macros.h).
+	 * @param sharedMemory If true, the peers in the same host exchange the Solutions through shared memory.
+	 *        In this case, the constructor and the destructor are collective operations over
+	 *        the TH instances of the same host.
+	 * @throws invalid_argument if the codec is unknown.
+	 */
+	CommEngine(MPI_Comm comm, int ID, int parent, int *children, int nChildren, int nDimensions, // @suppress("Class members should be properly initialized")
+			int codec = EXCHANGE_CODEC_RAW, bool sharedMemory = false) {
+		if(codec != EXCHANGE_CODEC_RAW && codec != EXCHANGE_CODEC_FP32 && codec != EXCHANGE_CODEC_DELTA) {
+			throw std::invalid_argument("Invalid exchange codec.");
+		}
+		this->codec = codec;
+		this->comm = comm;
+		this->ID = ID;
+		this->parent = parent;
+		this->nChildren = nChildren;
+		n = nDimensions;
+		finalized = false;
+		discardParentData = false;
+		finalizeSignal = 0;
+		commThread = NULL;
+		stopRequested.store(false);
+		useMailboxes = false;
+		childInMail = childOutMail = NULL;
+		parentInMail = parentOutMail = NULL;
+		childPending = NULL;
+		parentPending = NULL;
+		createPacketType();
+		scratch = newReference();
+
+		parentIndex = nChildren;
+		finalizeIndex = parentIndex + 1;
+		nRecvRequests = finalizeIndex + 1;
+		recvRequests = new MPI_Request[nRecvRequests];
+		recvActive = new bool[nRecvRequests];
+		completedIndices = new int[nRecvRequests];
+		for(int i=0; i < nRecvRequests; i++) {
+			recvRequests[i] = MPI_REQUEST_NULL;
+			recvActive[i] = false;
+		}
+
+		this->children = new int[nChildren];
+		childInbound = new Inbound[nChildren];
+		childStatus = new int[nChildren];
+		childLinkStatus = new int[nChildren];
+		childCurrent = new Solution<P, pSize, F, fSize, V, vSize>*[nChildren];
+		childHasNew = new bool[nChildren];
+		childPeeked = new bool[nChildren];
+		childSendRequests = new MPI_Request[nChildren];
+		childSendPackets = new char*[nChildren];
+		childSendReference = new P*[nChildren];
+		childSendActive = new bool[nChildren];
+		childSendShared = new char*[nChildren];
+		for(int i=0; i < nChildren; i++) {
+			this->children[i] = children[i];
+			childSendShared[i] = NULL;
+			childInbound[i].shared = NULL;
+			childInbound[i].sequence = 0;
+			childInbound[i].sharedActive = false;
+		}
+		parentSendShared = NULL;
+		parentInbound.shared = NULL;
+		parentInbound.sequence = 0;
+		parentInbound.sharedActive = false;
+		nSharedInbound = 0;
+		hostComm = MPI_COMM_NULL;
+		sharedWindow = MPI_WIN_NULL;
+		if(sharedMemory) createSharedWindow();
+
+		for(int i=0; i < nChildren; i++) {
+			childSendPackets[i] = newPacket();
+			childSendReference[i] = (codec == EXCHANGE_CODEC_RAW ? NULL : newReference());
+			childStatus[i] = childLinkStatus[i] = 0;
+			childCurrent[i] = NULL;
+			childHasNew[i] = childPeeked[i] = false;
+			childSendActive[i] = false;
+			initInbound(childInbound[i], children[i], MSG_CHILD2PARENT);
+			childSendRequests[i] = MPI_REQUEST_NULL;
+			if(codec == EXCHANGE_CODEC_RAW && childSendShared[i] == NULL) {
+				MPI_Send_init(childSendPackets[i], 1, packetType, children[i], MSG_PARENT2CHILD, comm, &childSendRequests[i]);
+			}
+		}
+
+		parentHasNew = parentPeeked = false;
+		parentCurrent = NULL;
+		parentSendActive = false;
+		parentSendPacket = NULL;
+		parentSendReference = NULL;
+		parentSendRequest = MPI_REQUEST_NULL;
+		if(hasParent()) {
+			parentSendPacket = newPacket();
+			initInbound(parentInbound, parent, MSG_PARENT2CHILD);
+			if(codec == EXCHANGE_CODEC_RAW) {
+				if(parentSendShared == NULL) MPI_Send_init(parentSendPacket, 1, packetType, parent, MSG_CHILD2PARENT, comm, &parentSendRequest);
+			}
+			else {
+				parentSendReference = newReference();
+			}
+		}
+	}
+	~CommEngine() {
+		shutdown();
+		if(childInMail != NULL) {
+			for(int i=0; i < nChildren; i++) {
+				delete childInMail[i];
+				delete childOutMail[i];
+			}
+			delete[] childInMail;
+			delete[] childOutMail;
+			delete[] childPending;
+			if(parentInMail != NULL) delete parentInMail;
+			if(parentOutMail != NULL) delete parentOutMail;
+		}
+		for(int i=0; i < nChildren; i++) {
+			delete[] childSendPackets[i];
+			deleteInbound(childInbound[i]);
+			if(childSendReference[i] != NULL) delete[] childSendReference[i];
+		}
+		delete[] childSendReference;
+		delete[] scratch;
+		delete[] children;
+		delete[] childInbound;
+		delete[] childStatus;
+		delete[] childLinkStatus;
+		delete[] childCurrent;
+		delete[] childHasNew;
+		delete[] childPeeked;
+		delete[] childSendRequests;
+		delete[] childSendPackets;
+		delete[] childSendActive;
+		if(parentSendPacket != NULL) delete[] parentSendPacket;
+		if(hasParent()) deleteInbound(parentInbound);
+		if(parentSendReference != NULL) delete[] parentSendReference;
+		delete[] recvRequests;
+		delete[] recvActive;
+		delete[] completedIndices;
+		delete[] childSendShared;
+		freeSharedWindow();
+	}
+
+	/**
+	 * @brief Post the receives of all inbound channels.
+	 */
+	void start() {
+		for(int i=0; i < nChildren; i++) startChildRecv(i);
+		if(hasParent()) startParentRecv();
+	}
+
+	/**
+	 * @brief Start the communication thread, which performs all MPI calls until {@link stopThread()}.
+	 *
+	 * Meanwhile, {@link poll()} only collects the Solutions already received by the
+	 * communication thread, and the Solutions sent are handed to the communication thread.
+	 * The MPI library must provide MPI_THREAD_SERIALIZED support.
+	 */
+	void startThread() {
+		if(commThread != NULL) return;
+		if(childInMail == NULL) {
+			childInMail = new Mailbox<Envelope>*[nChildren];
+			childOutMail = new Mailbox<Envelope>*[nChildren];
+			childPending = new Envelope*[nChildren];
+			for(int i=0; i < nChildren; i++) {
+				childInMail[i] = newMailbox();
+				childOutMail[i] = newMailbox();
+				childPending[i] = NULL;
+			}
+			if(hasParent()) {
+				parentInMail = newMailbox();
+				parentOutMail = newMailbox();
+			}
+		}
+		useMailboxes = true;
+		stopRequested.store(false, std::memory_order_release);
+		commThread = new std::thread(&CommEngine::commThreadLoop, this);
+	}
+
+	/**
+	 * @brief Stop the communication thread (if running), returning the MPI calls to the caller's thread.
+	 *
+	 * Solutions still waiting for a previous send to the same peer are attempted once more,
+	 * and then dropped if the peer is still busy.
+	 */
+	void stopThread() {
+		if(commThread == NULL) return;
+		stopRequested.store(true, std::memory_order_release);
+		commThread->join();
+		delete commThread;
+		commThread = NULL;
+		useMailboxes = false;
+		for(int i=0; i < nChildren; i++) {
+			if(childPending[i] != NULL && childLinkStatus[i] >= 0) sendToChildNow(i, childPending[i]->solution);
+			childPending[i] = NULL;
+		}
+		if(parentPending != NULL) sendToParentNow(parentPending->solution, parentPending->status, parentPending->lossless);
+		parentPending = NULL;
+	}
+
+	/**
+	 * @brief Progress all inbound channels without blocking.
+	 *
+	 * Every peer's inbox is updated with the last Solution received.
+	 */
+	void poll() {
+		collectMailboxes();
+		if(commThread == NULL) progress(false);
+	}
+
+	/**
+	 * @brief Block (without polling) until some inbound data arrives, then progress all inbound channels.
+	 *
+	 * The communication thread is stopped, if running.
+	 *
+	 * @return False if there is no inbound channel left to wait for. True otherwise.
+	 */
+	bool waitSome() {
+		stopThread();
+		if(collectMailboxes()) return true;
+		return progress(true) > 0;
+	}
+
+	/**
+	 * @brief From now on, discard the data received from the parent.
+	 *
+	 * The receive from the parent remains posted, so that the parent is never blocked.
+	 * The communication thread is stopped, if running.
+	 */
+	void discardParent() {
+		stopThread();
+		discardParentData = true;
+		parentHasNew = false;
+	}
+
+	/**
+	 * @brief Check if the child has sent a Solution not consumed yet.
+	 * @param i The child index.
+	 */
+	bool hasNewFromChild(int i) {
+		return childHasNew[i];
+	}
+
+	/**
+	 * @brief Get the last Solution received from the child and mark it as consumed.
+	 *
+	 * The Solution instance is owned by the engine and is lent to the caller, which can
+	 * modify it freely (e.g. run a local search over it) until the next call to
+	 * {@link poll()} or {@link waitSome()}, when it can be reused as a receive buffer.
+	 *
+	 * @param i The child index.
+	 * @return The last Solution received from the child.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* takeFromChild(int i) {
+		childHasNew[i] = false;
+		return childCurrent[i];
+	}
+
+	/**
+	 * @brief Get the last Solution received from the child, without consuming it.
+	 *
+	 * Every Solution received is returned only once by this method, and it remains
+	 * available to {@link takeFromChild(int)}. The Solution is lent under the same
+	 * terms of {@link takeFromChild(int)}, but it must not be modified.
+	 *
+	 * @param i The child index.
+	 * @return The last Solution received from the child, or NULL if it has been consumed or already peeked.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* peekFromChild(int i) {
+		if(!childHasNew[i] || childPeeked[i]) return NULL;
+		childPeeked[i] = true;
+		return childCurrent[i];
+	}
+
+	/**
+	 * @brief Get the last status received from the child.
+	 * @param i The child index.
+	 */
+	int getChildStatus(int i) {
+		return childStatus[i];
+	}
+
+	/**
+	 * @brief Check if the parent has sent a Solution not consumed yet.
+	 */
+	bool hasNewFromParent() {
+		return parentHasNew;
+	}
+
+	/**
+	 * @brief Get the last Solution received from the parent and mark it as consumed.
+	 *
+	 * The Solution instance is owned by the engine and is lent to the caller, which can
+	 * modify it freely (e.g. run a local search over it) until the next call to
+	 * {@link poll()} or {@link waitSome()}, when it can be reused as a receive buffer.
+	 *
+	 * @return The last Solution received from the parent.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* takeFromParent() {
+		parentHasNew = false;
+		return parentCurrent;
+	}
+
+	/**
+	 * @brief Get the last Solution received from the parent, without consuming it.
+	 *
+	 * Same as {@link peekFromChild(int)}, for the parent.
+	 *
+	 * @return The last Solution received from the parent, or NULL if it has been consumed or already peeked.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* peekFromParent() {
+		if(!parentHasNew || parentPeeked) return NULL;
+		parentPeeked = true;
+		return parentCurrent;
+	}
+
+	/**
+	 * @brief Send a Solution to the child, unless the previous send is still in progress.
+	 *
+	 * While the communication thread is running, the Solution is handed to it and sent as soon as possible.
+	 * @param i The child index.
+	 * @param solution The Solution to send.
+	 * @return True if the Solution was sent (or if it is identical to the last one sent). False otherwise.
+	 */
+	bool trySendToChild(int i, Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		if(commThread != NULL) {
+			*childOutMail[i]->getBack()->solution = solution;
+			childOutMail[i]->publish();
+			return true;
+		}
+		return sendToChildNow(i, solution);
+	}
+
+	/**
+	 * @brief Send a Solution and the current status to the parent, unless the previous send is still in progress.
+	 *
+	 * While the communication thread is running, the Solution is handed to it and sent as soon as possible.
+	 * @param solution The Solution to send.
+	 * @param status The status of this TH instance.
+	 * @param lossless If true, the Solution is sent without any precision loss, and even if it is
+	 *        identical to the last one sent (the codec is still applied, if lossless).
+	 * @return True if the Solution was sent (or if it is identical to the last one sent). False otherwise.
+	 */
+	bool trySendToParent(Solution<P, pSize, F, fSize, V, vSize> *solution, int status, bool lossless = false) {
+		if(commThread != NULL) {
+			Envelope *envelope = parentOutMail->getBack();
+			*envelope->solution = solution;
+			envelope->status = status;
+			envelope->lossless = lossless;
+			parentOutMail->publish();
+			return true;
+		}
+		return sendToParentNow(solution, status, lossless);
+	}
+
+	/**
+	 * @brief Send a Solution and the current status to the parent (always lossless), waiting for the previous send to complete.
+	 * @param solution The Solution to send.
+	 * @param status The status of this TH instance.
+	 */
+	void sendToParent(Solution<P, pSize, F, fSize, V, vSize> *solution, int status) {
+		stopThread();
+		if(parentSendActive) {
+			check(MPI_Wait(&parentSendRequest, MPI_STATUS_IGNORE), "waiting for the parent to read the last package from", parent);
+			parentSendActive = false;
+		}
+		sendToParentNow(solution, status, true);
+	}
+
+	/**
+	 * @brief Wait until all children have received the last Solution sent to them.
+	 */
+	void flushChildren() {
+		stopThread();
+		for(int i=0; i < nChildren; i++) {
+			if(!childSendActive[i]) continue;
+			check(MPI_Wait(&childSendRequests[i], MPI_STATUS_IGNORE), "waiting for the last package to be read by child", children[i]);
+			childSendActive[i] = false;
+		}
+	}
+
+	/**
+	 * @brief Wait (without polling) for the finalization signal from the parent,
+	 *        while discarding any Solution the parent may still send.
+	 */
+	void waitFinalization() {
+		if(!hasParent()) return;
+		discardParent();
+		check(MPI_Irecv(&finalizeSignal, 1, MPI_INT, parent, MSG_FINALIZE, comm, &recvRequests[finalizeIndex]), "waiting for finalization signal from parent", parent);
+		recvActive[finalizeIndex] = true;
+		while(!finalized) progress(true);
+	}
+
+	/**
+	 * @brief Cancel the pending receives and release all persistent requests.
+	 *
+	 * It must be called only after the peers have stopped communicating with this TH instance.
+	 */
+	void shutdown() {
+		stopThread();
+		for(int i=0; i < nChildren; i++) releaseInbound(childInbound[i], i);
+		if(hasParent()) releaseInbound(parentInbound, parentIndex);
+		for(int i=0; i < nRecvRequests; i++) {
+			if(recvActive[i]) {
+				MPI_Cancel(&recvRequests[i]);
+				MPI_Wait(&recvRequests[i], MPI_STATUS_IGNORE);
+				recvActive[i] = false;
+			}
+			if(recvRequests[i] != MPI_REQUEST_NULL) MPI_Request_free(&recvRequests[i]);
+		}
+		for(int i=0; i < nChildren; i++) {
+			if(childSendActive[i]) {
+				MPI_Wait(&childSendRequests[i], MPI_STATUS_IGNORE);
+				childSendActive[i] = false;
+			}
+			if(childSendRequests[i] != MPI_REQUEST_NULL) MPI_Request_free(&childSendRequests[i]);
+		}
+		if(parentSendActive) {
+			MPI_Wait(&parentSendRequest, MPI_STATUS_IGNORE);
+			parentSendActive = false;
+		}
+		if(parentSendRequest != MPI_REQUEST_NULL) MPI_Request_free(&parentSendRequest);
+		if(packetType != MPI_DATATYPE_NULL) MPI_Type_free(&packetType);
+	}
+
+	bool hasParent() {
+		return parent >= 0;
+	}
+
+	int getNChildren() {
+		return nChildren;
+	}
+
+	int getChildID(int i) {
+		return children[i];
+	}
+};
+
+#endif /* COMMENGINE_H_ */
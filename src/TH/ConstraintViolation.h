@@ -25,6 +25,8 @@
  * @details The constraint violations are represented by an ordered list with
  *          any number of elements, whose type must be of same basic data type
  *          for all elements (eg., double or int).
+ *          The number of elements is fixed by the template, so a ConstraintViolation
+ *          holds the values only and is trivially copyable.
  */
 
 #ifndef CONSTRAINTVIOLATIONS_H_
@@ -35,15 +37,12 @@
 template <class V = double, int vSize = 1>
 struct ConstraintViolation {
 	V internalViolations[vSize];
-	int size = vSize;
+	static constexpr int size = vSize;
 
 	void checkCompatibility(ConstraintViolation<V, vSize> *violation) {
 		if(violation == NULL) {
 			throw std::invalid_argument("Violation can not be empty.");
 		}
-		if(size != violation->size) {
-			throw std::invalid_argument("Violation's internal size is not compatible.");
-		}
 	}
 
 public:
@@ -64,27 +63,13 @@ public:
 	 *        constraint violations with the contents of the
 	 *        ConstraintViolation instance received.
 	 * @param fitness The source ConstraintViolation instance.
-	 * @throws invalid_argument if the source ConstraintViolation instance
-	 *         is not compatible with current ConstraintViolation instance.
+	 * @throws invalid_argument if the source ConstraintViolation instance is empty.
 	 */
 	void operator =(ConstraintViolation<V, vSize> *violation){
 		checkCompatibility(violation);
 		*this = violation->internalViolations;
 	}
 
-	/**
-	 * @brief Operator that overrides the contents of this list of
-	 *        constraint violations with the contents of the
-	 *        ConstraintViolation instance received.
-	 * @param fitness The source ConstraintViolation instance.
-	 * @throws invalid_argument if the source ConstraintViolation instance
-	 *         is not compatible with current ConstraintViolation instance.
-	 */
-	void operator =(ConstraintViolation<V, vSize> &violation){
-		checkCompatibility(&violation);
-		*this = violation.internalViolations;
-	}
-
 	/**
 	 * @brief Operator that assigns the same value to all elements of the list
 	 *        that represents the current ConstraintViolation.
@@ -116,8 +101,7 @@ public:
 	 * @param violation The ConstraintViolation instance to compare.
 	 * @return True if this ConstraintViolation instance has the same contents as the
 	 *         one received. False otherwise.
-	 * @throws invalid_argument if the ConstraintViolation instance received
-	 *         is not compatible with current list of constraint violations.
+	 * @throws invalid_argument if the ConstraintViolation instance received is empty.
 	 */
 	bool equals(ConstraintViolation<V, vSize> *violation){
 		checkCompatibility(violation);
@@ -181,4 +165,7 @@ public:
 	int getViolationSize() { return size; }
 };
 
+template <class V, int vSize>
+constexpr int ConstraintViolation<V, vSize>::size;
+
 #endif /* CONSTRAINTVIOLATIONS_H_ */
@@ -29,10 +29,35 @@
 #define CONVERGENCECONTROLPOLICY_H_
 
 #include "Search.h"
+#include "ImmigrationSource.h"
+
+#include <chrono>
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class ConvergenceControlPolicy {
 	int budgetSize;
+	ImmigrationSource<P, pSize, F, fSize, V, vSize> *immigrationSource;
+	std::chrono::steady_clock::time_point deadline;
+
+protected:
+	/**
+	 * @brief Inject all the immigrants available into the running optimization method.
+	 *
+	 * Implementations of {@link run(Search*)} should call this method between
+	 * consecutive calls to {@link Search::next(int)}.
+	 *
+	 * @param search The optimization method.
+	 * @return The number of immigrants accepted by the optimization method.
+	 */
+	int admitImmigrants(Search<P, pSize, F, fSize, V, vSize> *search) {
+		if(immigrationSource == NULL) return 0;
+		int accepted = 0;
+		Solution<P, pSize, F, fSize, V, vSize> *immigrant;
+		while((immigrant = immigrationSource->nextImmigrant()) != NULL) {
+			if(search->injectImmigrant(immigrant)) accepted++;
+		}
+		return accepted;
+	}
 
 public:
 	/**
@@ -41,6 +66,8 @@ public:
 	 */
 	ConvergenceControlPolicy(int budgetSize) {
 		this->budgetSize = budgetSize;
+		immigrationSource = NULL;
+		deadline = std::chrono::steady_clock::time_point::max();
 	}
 	virtual ~ConvergenceControlPolicy() {}
 
@@ -51,6 +78,9 @@ public:
 	 * sequential iterations of the actual optimization method, through the call of
 	 * {@link Search::next(int)}.
 	 *
+	 * It must also pass the deadline to the optimization method (see {@link Search::setDeadline()}),
+	 * and stop once the deadline has passed.
+	 *
 	 * @param search The optimization method.
 	 */
 	virtual void run(Search<P, pSize, F, fSize, V, vSize> *search) = 0;
@@ -59,6 +89,34 @@ public:
 	 * @brief Get the maximum number of fitness function evaluations allowed.
 	 */
 	int getBudgetSize() { return budgetSize; }
+
+	/**
+	 * @brief Set the source of the Solutions to be injected while the optimization method runs.
+	 * @param immigrationSource The immigration source, or NULL to disable the injection (default).
+	 */
+	void setImmigrationSource(ImmigrationSource<P, pSize, F, fSize, V, vSize> *immigrationSource) {
+		this->immigrationSource = immigrationSource;
+	}
+
+	/**
+	 * @brief Set the moment all optimizations must stop (TH sets it from {@link THBuilder::setMaxTimeSeconds()}).
+	 * @param deadline The deadline, or time_point::max() for no deadline (default).
+	 */
+	void setDeadline(std::chrono::steady_clock::time_point deadline) {
+		this->deadline = deadline;
+	}
+
+	std::chrono::steady_clock::time_point getDeadline() {
+		return deadline;
+	}
+
+	/**
+	 * @brief Check if the deadline has passed.
+	 */
+	bool isTimeUp() {
+		return deadline != std::chrono::steady_clock::time_point::max()
+				&& std::chrono::steady_clock::now() >= deadline;
+	}
 };
 
 #endif /* CONVERGENCECONTROLPOLICY_H_ */
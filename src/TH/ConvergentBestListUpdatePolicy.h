@@ -69,13 +69,7 @@ public:
 				}
 			}
 		}
-		if(worst > -1){
-			Solution<P, pSize, F, fSize, V, vSize> *worstSolution = (*bestList)[worst];
-			if(worstSolution == NULL) {
-				bestList->set(worst, new Solution<P, pSize, F, fSize, V, vSize>(solution));
-			}
-			else *worstSolution = solution;
-		}
+		if(worst > -1) bestList->store(worst, solution);
 	}
 };
 
@@ -26,6 +26,8 @@
  *          (eg. multi-objective optimization, fitness history, score list, etc).
  *          The fitness is an ordered list with any number of elements, whose type must be
  *          of same basic data type for all elements (eg., double or int).
+ *          The number of values is fixed by the template, so a Fitness holds the values only
+ *          and is trivially copyable.
  */
 
 #ifndef FITNESS_H_
@@ -36,15 +38,12 @@
 template <class F = double, int fSize = 1>
 struct Fitness {
 	F internalFitness[fSize];
-	int size = fSize;
+	static constexpr int size = fSize;
 
 	void checkCompatibility(Fitness<F, fSize> *fitness) {
 		if(fitness == NULL) {
 			throw std::invalid_argument("Fitness can not be empty.");
 		}
-		if(size != fitness->size) {
-			throw std::invalid_argument("Fitness's internal size is not compatible.");
-		}
 	}
 
 public:
@@ -67,24 +66,13 @@ public:
 	 * @brief Operator that overrides the contents of this fitness with
 	 *        the contents of the Fitness instance received.
 	 * @param fitness The source Fitness instance.
-	 * @throws invalid_argument if the source Fitness instance is not compatible with current fitness.
+	 * @throws invalid_argument if the source Fitness instance is empty.
 	 */
 	void operator =(Fitness<F, fSize> *fitness){
 		checkCompatibility(fitness);
 		*this = fitness->internalFitness;
 	}
 
-	/**
-	 * @brief Operator that overrides the contents of this fitness with
-	 *        the contents of the Fitness instance received.
-	 * @param fitness The source Fitness instance.
-	 * @throws invalid_argument if the source Fitness instance is not compatible with current fitness.
-	 */
-	void operator =(Fitness<F, fSize> &fitness){
-		checkCompatibility(&fitness);
-		*this = fitness.internalFitness;
-	}
-
 	/**
 	 * @brief Operator that assigns the same value to all elements of the list
 	 *        that represents the current Fitness.
@@ -118,7 +106,7 @@ public:
 	 * @param fitness The Fitness instance to compare.
 	 * @return True if this Fitness instance has the same contents as the
 	 *         fitness received. False otherwise.
-	 * @throws invalid_argument if the fitness received is not compatible with current fitness.
+	 * @throws invalid_argument if the fitness received is empty.
 	 */
 	bool equals(Fitness<F, fSize> *fitness){
 		checkCompatibility(fitness);
@@ -189,4 +177,7 @@ public:
 	int getFitnessSize() { return size; }
 };
 
+template <class F, int fSize>
+constexpr int Fitness<F, fSize>::size;
+
 #endif /* FITNESS_H_ */
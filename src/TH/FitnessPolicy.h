@@ -33,11 +33,18 @@
 
 #include "Solution.h"
 #include "THTree.h"
+#include "ThreadPool.h"
+
+#include <type_traits>
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class FitnessPolicy {
+	ThreadPool *threadPool;
+
 public:
-	FitnessPolicy(){}
+	FitnessPolicy(){
+		threadPool = NULL;
+	}
 	virtual ~FitnessPolicy(){}
 
 	/**
@@ -50,6 +57,111 @@ public:
 	 */
 	virtual void apply(Solution<P, pSize, F, fSize, V, vSize> *solution) = 0;
 
+	/**
+	 * @brief This method updates the fitness of a Solution instance after a few of its dimensions have changed.
+	 *
+	 * The Solution must hold the fitness (and constraint violations) calculated for its positions
+	 * before the change. Fitness functions that are separable (or partially separable) can override
+	 * this method to update only the terms affected by the changed dimensions, reducing the cost of
+	 * a move from O(n) to O(k). The default implementation simply calls {@link apply()}.
+	 *
+	 * Notice that incremental updates accumulate rounding errors, which are bounded by the precision
+	 * of the fitness function.
+	 *
+	 * @param solution The Solution instance to be evaluated, with its new positions.
+	 * @param changedDims The indices of the k dimensions changed.
+	 * @param oldValues The values of the changed dimensions before the change (k * pSize values,
+	 *                  in the same order of changedDims).
+	 * @param k The number of dimensions changed.
+	 */
+	virtual void applyDelta(Solution<P, pSize, F, fSize, V, vSize> *solution, int *changedDims, P *oldValues, int k) {
+		apply(solution);
+	}
+
+	/**
+	 * @brief This method calculates the fitness for a batch of Solution instances.
+	 *
+	 * TH framework always evaluates whole populations through this method.
+	 * The default implementation simply calls {@link apply()} for every Solution instance,
+	 * distributing the batch among the threads of the pool when one is set
+	 * (see {@link setThreadPool()}). In that case, {@link apply()} must be thread-safe.
+	 * It can also be overridden to vectorize, parallelize or amortize the setup
+	 * of expensive fitness functions across the entire batch.
+	 *
+	 * @param solutions The list of Solution instances to be evaluated.
+	 * @param count The number of Solution instances in the list.
+	 */
+	virtual void applyBatch(Solution<P, pSize, F, fSize, V, vSize> **solutions, int count) {
+		applyEach(this, solutions, count);
+	}
+
+	/**
+	 * @brief Evaluate a batch of Solution instances through a fitness policy of a known type.
+	 *
+	 * Same as the default {@link applyBatch()}, except that every call is made to Policy::apply().
+	 * When Policy is a concrete (final) fitness policy, the calls are bound at compile time and
+	 * can be inlined, which is what the search algorithms instantiated with the type of their
+	 * fitness policy use when it does not override {@link applyBatch()} (see {@link applyBatchOf()}).
+	 *
+	 * @param policy The fitness policy.
+	 * @param solutions The list of Solution instances to be evaluated.
+	 * @param count The number of Solution instances in the list.
+	 */
+	template <class Policy>
+	static void applyEach(Policy *policy, Solution<P, pSize, F, fSize, V, vSize> **solutions, int count) {
+		if(solutions == NULL) return;
+		ThreadPool *threadPool = policy->getThreadPool();
+		if(threadPool != NULL && count > 1) {
+			threadPool->parallelFor(count, [&](int begin, int end, int worker) {
+				for(int i=begin; i < end; i++){
+					policy->apply(solutions[i]);
+				}
+			});
+			return;
+		}
+		for(int i=0; i < count; i++){
+			policy->apply(solutions[i]);
+		}
+	}
+
+	/**
+	 * @brief Evaluate a batch of Solution instances through a fitness policy of a known type.
+	 *
+	 * Calls Policy::applyBatch() when Policy is this interface or overrides {@link applyBatch()}
+	 * (e.g. to deduplicate, vectorize or offload the batch), so that the override is never skipped.
+	 * Otherwise, the batch goes through {@link applyEach()}, bound at compile time to Policy::apply().
+	 *
+	 * @param policy The fitness policy.
+	 * @param solutions The list of Solution instances to be evaluated.
+	 * @param count The number of Solution instances in the list.
+	 */
+	template <class Policy>
+	static void applyBatchOf(Policy *policy, Solution<P, pSize, F, fSize, V, vSize> **solutions, int count) {
+		// &Policy::applyBatch only has the type of a member of this class if Policy inherits it unchanged.
+		typedef void (FitnessPolicy::*InheritedBatch)(Solution<P, pSize, F, fSize, V, vSize>**, int);
+		if(std::is_same<Policy, FitnessPolicy>::value
+				|| !std::is_same<decltype(&Policy::applyBatch), InheritedBatch>::value) {
+			policy->applyBatch(solutions, count);
+		}
+		else applyEach(policy, solutions, count);
+	}
+
+	/**
+	 * @brief Set the pool of threads used to evaluate the batches in parallel.
+	 *
+	 * The pool is owned by the TH framework, which sets it when more than one
+	 * thread is configured (see {@link THBuilder::setNThreads()}).
+	 *
+	 * @param threadPool The thread pool, or NULL to evaluate sequentially.
+	 */
+	void setThreadPool(ThreadPool *threadPool) {
+		this->threadPool = threadPool;
+	}
+
+	ThreadPool* getThreadPool() {
+		return threadPool;
+	}
+
 	/**
 	 * @brief Check if the first Solution is better than the second Solution.
 	 *
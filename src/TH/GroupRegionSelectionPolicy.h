@@ -31,6 +31,7 @@
 #define TH_GROUPREGIONSELECTIONPOLICY_H_
 
 #include "RegionSelectionPolicy.h"
+#include <climits>
 #include <cmath>
 #include <cstring>
 
@@ -39,47 +40,35 @@ class GroupRegionSelectionPolicy : public RegionSelectionPolicy<P, pSize, F, fSi
 	int nGroups;
 	int K;
 
-	Region<P>* internalLoop(Region<P> *region, vector<int> *hierarchy, t_node *node, int ID) {
-		if(node->getID() == ID){ // If the recursive iteration found the ID's sub-region.
-			return new Region<P>(region);
-		}
-		// Obtains the correct subdivision of node's search space by finding
-		// the node's child that is in the top of ID's parentage.
-		std::vector<t_node*> *children = node->getChildren();
-		for(int childPos=0, top=hierarchy->size()-1; childPos < (int)children->size(); childPos++) {
-			// If this child is in top of ID's parentage.
-			if((*children)[childPos]->getID() == (*hierarchy)[top]){
-				// Find child's coordinate in dimension grouping.
-				int coord[nGroups];
-				memset(coord, 0, sizeof(int)*nGroups);
-				for(int pos=childPos, g=nGroups-1, base; g >= 0; g--) {
-					base = pow(K, g);
-					if(base <= pos) {
-						coord[g] = pos / base; // Simplified coordinate in group g.
-						pos %= base;
-					}
-				}
-				// Convert: child's coordinate in dimension grouping -> search space boundaries inside parent's subregion.
-				int nDim = region->getNDimensions();
-				int dimPerGroup = nDim / nGroups;
-				Region<P> subRegion(region);
-				Partition<P>* partition;
-				P delta, minimum;
-				for(int d=0, g=0; d < nDim; d++){
-					partition = (*region)[d]; // Perform the partitioning using the sequential order of dimension's ID.
-					delta = (partition->getEndPoint() - partition->getStartPoint()) / K;
-					minimum = partition->getStartPoint() + coord[g] * delta;
-					subRegion[d]->setStartPoint(minimum);
-					subRegion[d]->setEndPoint((coord[g]<K-1) ? minimum + delta : partition->getEndPoint());
-					if((d+1) % dimPerGroup == 0) g++; // Move to the next group.
-				}
-				hierarchy->pop_back(); // Remove the node that is in the top of ID's parentage.
-				// Re-partition the just found sub-region according to ID's descendancy.
-				return internalLoop(&subRegion, hierarchy, (*children)[childPos], ID);
+	/**
+	 * @brief Partition the working region in place, keeping the sub-region of the child node
+	 *        at the given position among its siblings.
+	 */
+	void selectChild(Region<P> *region, int childPos) {
+		// Find child's coordinate in dimension grouping.
+		int coord[nGroups];
+		memset(coord, 0, sizeof(int)*nGroups);
+		for(int pos=childPos, g=nGroups-1, base; g >= 0; g--) {
+			base = pow(K, g);
+			if(base <= pos) {
+				coord[g] = pos / base; // Simplified coordinate in group g.
+				pos %= base;
 			}
 		}
-
-		return NULL;
+		// Convert: child's coordinate in dimension grouping -> search space boundaries inside parent's subregion.
+		int nDim = region->getNDimensions();
+		int dimPerGroup = nDim / nGroups;
+		Partition<P>* partition;
+		P delta, minimum, maximum;
+		for(int d=0, g=0; d < nDim; d++){
+			partition = (*region)[d]; // Perform the partitioning using the sequential order of dimension's ID.
+			maximum = partition->getEndPoint();
+			delta = (maximum - partition->getStartPoint()) / K;
+			minimum = partition->getStartPoint() + coord[g] * delta;
+			partition->setStartPoint(minimum);
+			partition->setEndPoint((coord[g]<K-1) ? minimum + delta : maximum);
+			if((d+1) % dimPerGroup == 0) g++; // Move to the next group.
+		}
 	}
 
 public:
@@ -94,6 +83,15 @@ public:
 	}
 	~GroupRegionSelectionPolicy() {}
 
+	/**
+	 * @brief Every group is split in K segments, so the policy can address K^nGroups child positions.
+	 */
+	long long getNChildPositions() {
+		long long nPositions = 1;
+		for(int g=0; g < nGroups && nPositions <= INT_MAX; g++) nPositions *= K;
+		return nPositions;
+	}
+
 	/**
 	 * @brief Method responsible for choosing one "anchor" sub-region according to the TH instance's ID.
 	 *
@@ -105,20 +103,22 @@ public:
 	 * @return The "anchor" sub-region for current TH instance.
 	 */
 	Region<P>* apply(SearchSpace<P> *S, THTree *thTree, int ID) {
+		// Collect the position of every node in ID's parentage among its siblings,
+		// from the current node up to the root's child.
 		vector<int> hierarchy = vector<int>();
-		t_node *node = thTree->getNode(ID); // Get the current node ID.
-		if(node == NULL) return NULL;
-
-		hierarchy.push_back(node->getID()); // Add the current node to the hierarchy.
-		t_node *root = thTree->getRootNode();
-		// Add all except the root node the current node's hierarchy.
-		for(t_node *parent=node->getParent(); parent != NULL && parent != root; parent=parent->getParent()) {
-			hierarchy.push_back(parent->getID());
+		for(int node=ID, parent; (parent = thTree->getParentID(node)) != -1; node=parent) {
+			int childPos = thTree->getChildPosition(node);
+			if(childPos < 0) return NULL;
+			hierarchy.push_back(childPos);
 		}
 
-		// Find the current node's sub-region,
-		// starting the recursive search from root's search space.
-		return internalLoop(S, &hierarchy, root, ID);
+		// Find the current node's sub-region, starting from root's search space
+		// and partitioning the working region in place down the tree, so no copies are made.
+		Region<P> *region = new Region<P>(S);
+		for(int level=hierarchy.size()-1; level >= 0; level--) {
+			selectChild(region, hierarchy[level]);
+		}
+		return region;
 	}
 };
 
@@ -0,0 +1,51 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file ImmigrationSource.h
+ * @class ImmigrationSource
+ * @author Peter Frank Perroni
+ * @brief Template for the providers of Solutions to be injected into a running Search.
+ * @details The ConvergenceControlPolicy drains its ImmigrationSource between two consecutive
+ *          calls to {@link Search::next(int)}, and hands every immigrant to
+ *          {@link Search::injectImmigrant(Solution*)}.
+ */
+
+#ifndef IMMIGRATIONSOURCE_H_
+#define IMMIGRATIONSOURCE_H_
+
+#include "Solution.h"
+
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class ImmigrationSource {
+public:
+	virtual ~ImmigrationSource() {}
+
+	/**
+	 * @brief Get the next immigrant available.
+	 *
+	 * The Solution returned must be already evaluated, and it is only guaranteed
+	 * to remain valid until the next call to this method.
+	 *
+	 * @return The next immigrant, or NULL if there is no immigrant available.
+	 */
+	virtual Solution<P, pSize, F, fSize, V, vSize>* nextImmigrant() = 0;
+};
+
+#endif /* IMMIGRATIONSOURCE_H_ */
@@ -28,9 +28,11 @@
 #define ITERATIONDATA_H_
 
 #include "Solution.h"
+#include "Population.h"
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 struct IterationData {
+	Population<P, pSize, F, fSize, V, vSize> *populationStore;
 	Solution<P, pSize, F, fSize, V, vSize> **population;
 	Solution<P, pSize, F, fSize, V, vSize> *generalBest;
 	Solution<P, pSize, F, fSize, V, vSize> *parentBest;
@@ -44,6 +46,24 @@ struct IterationData {
 	long long maxNumberEvaluations;
 	long maxIterations;
 
+	void setup(int populationSize, int n, long maxTimeSeconds, long long maxNumberEvaluations, long maxIterations) {
+		this->n = n;
+		iterationBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
+		parentBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
+		generalBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
+
+		this->populationSize = populationSize;
+		populationStore = new Population<P, pSize, F, fSize, V, vSize>(populationSize, n);
+		population = populationStore->getSolutions();
+
+		this->maxTimeSeconds = maxTimeSeconds;
+		this->maxNumberEvaluations = maxNumberEvaluations;
+		this->maxIterations = maxIterations;
+		currTime = 0;
+		currIteration = 0;
+		currNumberEvaluation = 0;
+	}
+
 public:
 	/**
 	 * @brief Constructor that creates an IterationData instance.
@@ -64,29 +84,32 @@ public:
 			throw std::invalid_argument("Population size must be greater than zero.");
 		}
 
-		n = population[0]->getNDimensions();
-		iterationBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
-		parentBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
-		generalBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
+		setup(populationSize, population[0]->getNDimensions(), maxTimeSeconds, maxNumberEvaluations, maxIterations);
+		setPopulation(population, populationSize);
+	}
 
-		this->populationSize = populationSize;
-		this->population = new Solution<P, pSize, F, fSize, V, vSize>*[populationSize];
-		for(int i=0; i < populationSize; i++){
-			this->population[i] = new Solution<P, pSize, F, fSize, V, vSize>(population[i]);
+	/**
+	 * @brief Constructor that creates an IterationData instance.
+	 * @param population A pointer to the actual contiguous population.
+	 *        The entire population is cloned (block by block) and then stored.
+	 * @param maxTimeSeconds The maximum time (in seconds) allowed to run.
+	 * @param maxNumberEvaluations The maximum number of Fitness evaluations allowed.
+	 * @param maxIterations The maximum number of TH iterations allowed.
+	 */
+	IterationData(Population<P, pSize, F, fSize, V, vSize> *population,
+			long maxTimeSeconds = 0,
+			long long maxNumberEvaluations = 0,
+			long maxIterations = 0) {
+
+		if(population == NULL) {
+			throw std::invalid_argument("Population cannot be empty.");
 		}
 
-		this->maxTimeSeconds = maxTimeSeconds;
-		this->maxNumberEvaluations = maxNumberEvaluations;
-		this->maxIterations = maxIterations;
-		currTime = 0;
-		currIteration = 0;
-		currNumberEvaluation = 0;
+		setup(population->getPopulationSize(), population->getNDimensions(), maxTimeSeconds, maxNumberEvaluations, maxIterations);
+		setPopulation(population);
 	}
 	~IterationData() {
-		for(int i=0; i < populationSize; i++){
-			delete population[i];
-		}
-		delete population;
+		delete populationStore;
 		delete iterationBest;
 		delete generalBest;
 		delete parentBest;
@@ -120,6 +143,17 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Copy the contents of the entire population to the internal clone.
+	 *
+	 * The copy is performed block by block.
+	 *
+	 * @param population The population at current state.
+	 */
+	void setPopulation(Population<P, pSize, F, fSize, V, vSize> *population) {
+		*populationStore = population;
+	}
+
 	Solution<P, pSize, F, fSize, V, vSize>** getPopulation() {
 		return population;
 	}
@@ -0,0 +1,176 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file KAryTHTree.h
+ * @class KAryTHTree
+ * @author Peter Frank Perroni
+ * @brief Implicit Treasure Hunt Tree Topology, with a fixed fanout per tree depth.
+ * @details The nodes are numbered in breadth-first order, from 0 (the root) to size-1,
+ *          and every node at depth d has fanout[d] children (the last fanout is repeated
+ *          for the deeper levels). Only the deepest level can be partially filled.
+ *
+ *          No node is stored: the level, the parent and the children of any node
+ *          are calculated in O(depth) from the first ID of every depth,
+ *          so every TH instance can set up a large topology in negligible time and memory.
+ *
+ *          For example, the topology of 7 TH instances where every node has 2 children:
+ *          <pre>
+ *          THTree* thTree = new KAryTHTree(7, 2);
+ *          </pre>
+ *          is the same as:
+ *          <pre>
+ *          THTree* thTree = new THTree(7);
+ *          thTree->addRootNode(0)->addNode(1, 0)->addNode(2, 0)
+ *                ->addNode(3, 1)->addNode(4, 1)->addNode(5, 2)->addNode(6, 2);
+ *          </pre>
+ */
+
+#ifndef TH_KARYTHTREE_H_
+#define TH_KARYTHTREE_H_
+
+#include "THTree.h"
+
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+class KAryTHTree : public THTree {
+	int size;
+	std::vector<int> fanouts;
+	std::vector<int> firstIDs; // The first ID of every depth (the root is at depth 0).
+
+	void init(int size, const std::vector<int> &fanouts) {
+		if(size <= 0) throw std::invalid_argument("The tree size must be greater than zero.");
+		if(fanouts.size() == 0) throw std::invalid_argument("At least one fanout must be provided.");
+		for(int fanout : fanouts) {
+			if(fanout <= 0) throw std::invalid_argument("The fanout must be greater than zero.");
+		}
+		this->size = size;
+		this->fanouts = fanouts;
+		long long first = 0, width = 1;
+		for(int d=0; first < size; d++) {
+			firstIDs.push_back(first);
+			first += width;
+			width *= getFanout(d);
+			if(width > size) width = size; // Avoid overflows, since the level cannot exceed the tree.
+		}
+	}
+
+	int getFanout(int depth) {
+		return fanouts[(depth < (int)fanouts.size()) ? depth : fanouts.size()-1];
+	}
+
+	int getDepth(int ID) {
+		if(ID < 0 || ID >= size) throw std::invalid_argument("Invalid node ID.");
+		int d = firstIDs.size() - 1;
+		while(firstIDs[d] > ID) d--;
+		return d;
+	}
+
+	void print(int ID) {
+		std::vector<int> children;
+		getChildrenIDs(ID, &children);
+		std::cout << "[ {" << ID << ", " << getLevel(ID) << "} ";
+		for(int child : children) print(child);
+		std::cout << "] ";
+	}
+
+public:
+	/**
+	 * @brief Constructor to create a tree topology where every node has up to K children.
+	 * @param size The number of nodes of the tree.
+	 * @param K The number of children of every node.
+	 * @throws invalid_argument if the size or K are not positive.
+	 */
+	KAryTHTree(int size, int K) : THTree() {
+		init(size, std::vector<int>(1, K));
+	}
+
+	/**
+	 * @brief Constructor to create a tree topology with a fanout per tree depth.
+	 * @param size The number of nodes of the tree.
+	 * @param fanouts The number of children of every node at depth d is fanouts[d],
+	 *        where the root is at depth 0. The last fanout applies to all deeper levels.
+	 * @throws invalid_argument if the size or any fanout is not positive.
+	 */
+	KAryTHTree(int size, const std::vector<int> &fanouts) : THTree() {
+		init(size, fanouts);
+	}
+	~KAryTHTree() {}
+
+	/**
+	 * @brief The implicit topology cannot be changed, so there is nothing to lock.
+	 */
+	void lock() {}
+
+	int getRootID() {
+		return 0;
+	}
+
+	int getRootLevel() {
+		return firstIDs.size();
+	}
+
+	int getLevel(int ID) {
+		return firstIDs.size() - getDepth(ID);
+	}
+
+	int getParentID(int ID) {
+		int d = getDepth(ID);
+		if(d == 0) return -1;
+		return firstIDs[d-1] + (ID - firstIDs[d]) / getFanout(d-1);
+	}
+
+	int getChildPosition(int ID) {
+		int d = getDepth(ID);
+		if(d == 0) return -1;
+		return (ID - firstIDs[d]) % getFanout(d-1);
+	}
+
+	int getNChildren(int ID) {
+		int d = getDepth(ID);
+		if(d+1 >= (int)firstIDs.size()) return 0;
+		long long first = firstIDs[d+1] + (long long)(ID - firstIDs[d]) * getFanout(d);
+		if(first >= size) return 0;
+		return (first + getFanout(d) <= size) ? getFanout(d) : size - first;
+	}
+
+	void getChildrenIDs(int ID, std::vector<int>* IDs) {
+		if(IDs == NULL) return;
+		int nChildren = getNChildren(ID);
+		if(nChildren == 0) return;
+		int d = getDepth(ID);
+		int first = firstIDs[d+1] + (ID - firstIDs[d]) * getFanout(d);
+		for(int i=0; i < nChildren; i++) {
+			IDs->push_back(first + i);
+		}
+	}
+
+	int getCurrentSize() {
+		return size;
+	}
+
+	void print() {
+		print(0);
+		std::cout << std::endl;
+	}
+};
+
+#endif /* TH_KARYTHTREE_H_ */
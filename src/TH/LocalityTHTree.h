@@ -0,0 +1,268 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file LocalityTHTree.h
+ * @class LocalityTHTree
+ * @author Peter Frank Perroni
+ * @brief Treasure Hunt Tree Topology built from the physical location of the MPI processes.
+ * @details The processes sharing the same host (as reported by MPI_Comm_split_type
+ *          with MPI_COMM_TYPE_SHARED) form a whole K-ary subtree, rooted at the
+ *          lowest ranked process of the host. The roots of these subtrees form
+ *          a K-ary tree among the hosts, rooted at the host of the rank 0.
+ *
+ *          Therefore, only the edges between the host roots cross the interconnect,
+ *          and all the exchanges below them (the most frequent ones, since most
+ *          TH instances are in the lower levels) stay inside the hosts.
+ *
+ *          Every host root has up to 2*K children: its K children inside the host
+ *          (positions 0 to K-1) followed by the roots of its K children hosts
+ *          (positions K to 2K-1). The region selection policy must be able to address
+ *          all these positions, e.g. GroupRegionSelectionPolicy(2, 2) for K=2
+ *          (see {@link getMaxChildPosition()}), which TH checks when it starts.
+ *
+ *          The tree is built collectively, by all the processes of the communicator,
+ *          and takes a few integers per process, with no per-node allocations.
+ *          The node IDs are the process ranks in the communicator.
+ */
+
+#ifndef TH_LOCALITYTHTREE_H_
+#define TH_LOCALITYTHTREE_H_
+
+#include "THTree.h"
+
+#include <mpi.h>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+class LocalityTHTree : public THTree {
+	int size, K, nHosts, LRoot;
+	std::vector<int> hostOf;		// Host index of every rank.
+	std::vector<int> hostPosition;	// Position of every rank inside its host.
+	std::vector<int> hostFirst;		// First index of every host in members (plus the end of the last host).
+	std::vector<int> members;		// Ranks grouped by host, in increasing order inside every host.
+
+	int getHostSize(int host) {
+		return hostFirst[host+1] - hostFirst[host];
+	}
+
+	int getMember(int host, int position) {
+		return members[hostFirst[host] + position];
+	}
+
+	/**
+	 * @brief Get the depth of the position in a K-ary tree numbered in breadth-first order.
+	 */
+	int getDepth(int position) {
+		int depth = 0;
+		for(long long first=0, width=1; first + width <= position; depth++) {
+			first += width;
+			width *= K;
+		}
+		return depth;
+	}
+
+	void checkID(int ID) {
+		if(ID < 0 || ID >= size) throw std::invalid_argument("Invalid node ID.");
+	}
+
+	/**
+	 * @brief Group the ranks by host, with the hosts sorted by their lowest rank.
+	 * @param leaders The lowest rank of the host of every rank.
+	 */
+	void group(const std::vector<int> &leaders) {
+		size = leaders.size();
+		hostOf.resize(size);
+		hostPosition.resize(size);
+		std::vector<int> hostSizes;
+		for(int r=0; r < size; r++) {
+			if(leaders[r] == r) { // The lowest rank of a host always comes first.
+				hostOf[r] = hostSizes.size();
+				hostSizes.push_back(0);
+			}
+			else hostOf[r] = hostOf[leaders[r]];
+			hostPosition[r] = hostSizes[hostOf[r]]++;
+		}
+		nHosts = hostSizes.size();
+		hostFirst.resize(nHosts + 1);
+		hostFirst[0] = 0;
+		for(int h=0; h < nHosts; h++) hostFirst[h+1] = hostFirst[h] + hostSizes[h];
+		members.resize(size);
+		for(int r=0; r < size; r++) members[hostFirst[hostOf[r]] + hostPosition[r]] = r;
+
+		// The deepest node is at the bottom of some host's subtree.
+		int maxDepth = 0;
+		for(int h=0; h < nHosts; h++) {
+			int depth = getDepth(h) + getDepth(getHostSize(h) - 1);
+			if(depth > maxDepth) maxDepth = depth;
+		}
+		LRoot = maxDepth + 1;
+	}
+
+	void print(int ID) {
+		std::vector<int> children;
+		getChildrenIDs(ID, &children);
+		std::cout << "[ {" << ID << ", " << getLevel(ID) << "} ";
+		for(int child : children) print(child);
+		std::cout << "] ";
+	}
+
+public:
+	/**
+	 * @brief Constructor to build the tree topology over the processes of the communicator.
+	 *
+	 * This is a collective operation: all the processes of the communicator must call it.
+	 *
+	 * @param comm The communicator of the TH instances (see {@link THBuilder::getCartGrid()}).
+	 * @param K The number of children of every node inside the hosts, and of every host.
+	 * @throws invalid_argument if the communicator is not valid or K is not positive.
+	 */
+	LocalityTHTree(MPI_Comm comm, int K) : THTree() {
+		if(comm == MPI_COMM_NULL) throw std::invalid_argument("The MPI communicator must be provided.");
+		if(K <= 0) throw std::invalid_argument("The fanout must be greater than zero.");
+		this->K = K;
+
+		// Find the lowest rank of this process' host.
+		int rank, leader;
+		MPI_Comm hostComm;
+		MPI_Comm_rank(comm, &rank);
+		MPI_Comm_size(comm, &size);
+		MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &hostComm);
+		leader = rank;
+		MPI_Bcast(&leader, 1, MPI_INT, 0, hostComm); // The host's ranks keep the order of comm.
+		MPI_Comm_free(&hostComm);
+
+		std::vector<int> leaders(size);
+		MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT, comm);
+
+		group(leaders);
+	}
+	~LocalityTHTree() {}
+
+	/**
+	 * @brief The topology is built by the constructor and cannot be changed, so there is nothing to lock.
+	 */
+	void lock() {}
+
+	int getRootID() {
+		return members[0];
+	}
+
+	int getRootLevel() {
+		return LRoot;
+	}
+
+	int getLevel(int ID) {
+		checkID(ID);
+		return LRoot - getDepth(hostOf[ID]) - getDepth(hostPosition[ID]);
+	}
+
+	int getParentID(int ID) {
+		checkID(ID);
+		int host = hostOf[ID], position = hostPosition[ID];
+		if(position > 0) return getMember(host, (position - 1) / K);
+		if(host > 0) return getMember((host - 1) / K, 0);
+		return -1;
+	}
+
+	int getChildPosition(int ID) {
+		checkID(ID);
+		int host = hostOf[ID], position = hostPosition[ID];
+		if(position > 0) return (position - 1) % K;
+		if(host > 0) return K + (host - 1) % K;
+		return -1;
+	}
+
+	int getNChildren(int ID) {
+		checkID(ID);
+		int host = hostOf[ID], position = hostPosition[ID];
+		long long nChildren = getHostSize(host) - ((long long)position*K + 1);
+		if(nChildren < 0) nChildren = 0;
+		else if(nChildren > K) nChildren = K;
+		if(position == 0) {
+			long long nChildrenHosts = nHosts - ((long long)host*K + 1);
+			if(nChildrenHosts > 0) nChildren += (nChildrenHosts > K) ? K : nChildrenHosts;
+		}
+		return nChildren;
+	}
+
+	/**
+	 * @brief Append the IDs of the children nodes to IDs: first the ones in the same host,
+	 *        then the roots of the children hosts.
+	 */
+	void getChildrenIDs(int ID, std::vector<int>* IDs) {
+		if(IDs == NULL) return;
+		checkID(ID);
+		int host = hostOf[ID], position = hostPosition[ID], hostSize = getHostSize(host);
+		for(long long child=(long long)position*K + 1; child <= (long long)position*K + K && child < hostSize; child++) {
+			IDs->push_back(getMember(host, child));
+		}
+		if(position == 0) {
+			for(long long child=(long long)host*K + 1; child <= (long long)host*K + K && child < nHosts; child++) {
+				IDs->push_back(getMember(child, 0));
+			}
+		}
+	}
+
+	int getCurrentSize() {
+		return size;
+	}
+
+	/**
+	 * @brief Get the number of children of every node inside the hosts, and of every host.
+	 */
+	int getFanout() {
+		return K;
+	}
+
+	/**
+	 * @brief Get the highest child position used in the tree.
+	 * @return The highest position (at most 2K-1 when the tree spans more than one host),
+	 *         or -1 if no node has children.
+	 */
+	int getMaxChildPosition() {
+		if(nHosts > 1) return K + ((nHosts - 1 < K) ? nHosts - 1 : K) - 1;
+		int nChildren = getHostSize(0) - 1;
+		return ((nChildren < K) ? nChildren : K) - 1;
+	}
+
+	/**
+	 * @brief Get the number of hosts the tree spans.
+	 */
+	int getNHosts() {
+		return nHosts;
+	}
+
+	/**
+	 * @brief Check if both nodes are in the same host.
+	 */
+	bool isSameHost(int ID1, int ID2) {
+		checkID(ID1);
+		checkID(ID2);
+		return hostOf[ID1] == hostOf[ID2];
+	}
+
+	void print() {
+		print(getRootID());
+		std::cout << std::endl;
+	}
+};
+
+#endif /* TH_LOCALITYTHTREE_H_ */
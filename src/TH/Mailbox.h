@@ -0,0 +1,104 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file Mailbox.h
+ * @class Mailbox
+ * @author Peter Frank Perroni
+ * @brief Lock-free single-slot mailbox between one writer thread and one reader thread.
+ * @details The mailbox is a triple buffer: the writer fills the back buffer and publishes it,
+ *          and the reader takes the last buffer published. Both operations are wait-free
+ *          (a single atomic exchange), a newer message simply replaces an older one
+ *          not taken yet, and neither thread ever sees a buffer being written by the other.
+ */
+
+#ifndef MAILBOX_H_
+#define MAILBOX_H_
+
+#include <atomic>
+#include <stdexcept>
+
+template <class T>
+class Mailbox {
+	static const int FRESH = 4; // Flag added to the middle index when it holds a message not taken yet.
+
+	T *buffers[3];
+	std::atomic<int> middle;
+	int back;	// Owned by the writer.
+	int front;	// Owned by the reader.
+
+public:
+	/**
+	 * @brief Constructor to create the mailbox over three buffers.
+	 *
+	 * The mailbox takes the ownership of the buffers (they are deleted with the mailbox).
+	 *
+	 * @throws invalid_argument if any buffer is empty.
+	 */
+	Mailbox(T *buffer0, T *buffer1, T *buffer2) {
+		if(buffer0 == NULL || buffer1 == NULL || buffer2 == NULL) {
+			throw std::invalid_argument("The mailbox buffers cannot be empty.");
+		}
+		buffers[0] = buffer0;
+		buffers[1] = buffer1;
+		buffers[2] = buffer2;
+		back = 0;
+		middle.store(1);
+		front = 2;
+	}
+	~Mailbox() {
+		for(int i=0; i < 3; i++) delete buffers[i];
+	}
+
+	/**
+	 * @brief Get the buffer the writer fills before calling {@link publish()}.
+	 */
+	T* getBack() {
+		return buffers[back];
+	}
+
+	/**
+	 * @brief Publish the back buffer (writer only), replacing any message not taken yet.
+	 */
+	void publish() {
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+	/**
+	 * @brief Check if there is a message not taken yet.
+	 */
+	bool hasNew() {
+		return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+	}
+
+	/**
+	 * @brief Take the last message published (reader only).
+	 *
+	 * The buffer returned belongs to the reader until the next call to this method.
+	 *
+	 * @return The last message published, or NULL if there is no message not taken yet.
+	 */
+	T* take() {
+		if(!hasNew()) return NULL;
+		front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+		return buffers[front];
+	}
+};
+
+#endif /* MAILBOX_H_ */
@@ -0,0 +1,215 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file Population.h
+ * @class Population
+ * @author Peter Frank Perroni
+ * @brief This class stores a whole population in contiguous memory.
+ * @details The Positions of all individuals are kept in one single aligned block
+ *          (individual after individual), while the Fitness and ConstraintViolation
+ *          of all individuals are kept in their own columns.
+ *          Every individual is exposed as a lightweight Solution instance that is
+ *          just a view into this storage, so that the search algorithms can keep
+ *          using the Solution interface without scattered allocations.
+ */
+
+#ifndef POPULATION_H_
+#define POPULATION_H_
+
+#include "Solution.h"
+#include "THUtil.h"
+
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string.h>
+
+template<class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class Population {
+	Position<P, pSize> *positions;
+	Fitness<F, fSize> *fitness;
+	ConstraintViolation<V, vSize> *violations;
+	Solution<P, pSize, F, fSize, V, vSize> **solutions;
+	int populationSize;
+	int n;
+
+	void setup(int populationSize, int nDimensions) {
+		if (populationSize <= 0) throw std::invalid_argument("The population size must be greater than zero.");
+		if (nDimensions <= 0) throw std::invalid_argument("The number of dimensions must be greater than zero.");
+		this->populationSize = populationSize;
+		n = nDimensions;
+
+		positions = (Position<P, pSize>*) THUtil::alignedAlloc((size_t)populationSize * n * sizeof(Position<P, pSize>));
+		fitness = (Fitness<F, fSize>*) THUtil::alignedAlloc(populationSize * sizeof(Fitness<F, fSize>));
+		violations = (ConstraintViolation<V, vSize>*) THUtil::alignedAlloc(populationSize * sizeof(ConstraintViolation<V, vSize>));
+		for (long i = 0, sz = (long)populationSize * n; i < sz; i++) new (&positions[i]) Position<P, pSize>();
+		for (int i = 0; i < populationSize; i++) {
+			new (&fitness[i]) Fitness<F, fSize>();
+			new (&violations[i]) ConstraintViolation<V, vSize>();
+		}
+
+		solutions = new Solution<P, pSize, F, fSize, V, vSize>*[populationSize];
+		for (int i = 0; i < populationSize; i++) {
+			solutions[i] = new Solution<P, pSize, F, fSize, V, vSize>(n, &positions[(long)i * n], &fitness[i], &violations[i]);
+		}
+	}
+
+	void checkCompatibility(Population<P, pSize, F, fSize, V, vSize> *population) {
+		if (population == NULL) {
+			throw std::invalid_argument("Population can not be empty.");
+		}
+		if (n != population->n || populationSize != population->populationSize) {
+			throw std::invalid_argument(std::string("Population's internal sizes are not compatible [")
+										+ std::to_string(populationSize) + "x" + std::to_string(n) + " != "
+										+ std::to_string(population->populationSize) + "x" + std::to_string(population->n) + "].");
+		}
+	}
+
+public:
+	/**
+	 * @brief This constructor creates an empty Population instance.
+	 * @param populationSize The number of individuals in the population.
+	 * @param nDimensions The number of dimensions of every individual.
+	 */
+	Population(int populationSize, int nDimensions) { // @suppress("Class members should be properly initialized")
+		setup(populationSize, nDimensions);
+	}
+
+	/**
+	 * @brief This constructor creates a Population instance by copying
+	 *        all contents of another Population instance.
+	 * @param population The source Population instance.
+	 */
+	Population(Population<P, pSize, F, fSize, V, vSize> *population) { // @suppress("Class members should be properly initialized")
+		if (population == NULL) throw std::invalid_argument("The original population is empty.");
+		setup(population->getPopulationSize(), population->getNDimensions());
+		*this = population;
+	}
+	~Population() {
+		for (int i = 0; i < populationSize; i++) {
+			delete solutions[i];
+		}
+		delete[] solutions;
+		THUtil::alignedFree(positions);
+		THUtil::alignedFree(fitness);
+		THUtil::alignedFree(violations);
+	}
+
+	/**
+	 * @brief Operator that overrides the Positions, Fitness and Violations of the
+	 *        entire population with the contents of the Population received.
+	 *
+	 * The copy is performed block by block, instead of individual by individual.
+	 *
+	 * @param population The source Population instance.
+	 * @throws invalid_argument if the source Population instance is not compatible with current population.
+	 */
+	void operator =(Population<P, pSize, F, fSize, V, vSize> *population) {
+		checkCompatibility(population);
+		if (this == population) return;
+		copyFrom(population, 0, populationSize);
+	}
+
+	void operator =(Population<P, pSize, F, fSize, V, vSize> &population) {
+		*this = &population;
+	}
+
+	/**
+	 * @brief Copy a range of individuals from another Population instance.
+	 * @param population The source Population instance.
+	 * @param first The index of the first individual to copy.
+	 * @param count The number of individuals to copy.
+	 * @throws invalid_argument if the source Population instance is not compatible with current population.
+	 */
+	void copyFrom(Population<P, pSize, F, fSize, V, vSize> *population, int first, int count) {
+		checkCompatibility(population);
+		if (first < 0 || count < 0 || first + count > populationSize) {
+			throw std::invalid_argument(std::string("Invalid population range [")
+										+ std::to_string(first) + ", " + std::to_string(first + count) + "[.");
+		}
+		memcpy(&positions[(long)first * n], &population->positions[(long)first * n], (size_t)count * n * sizeof(Position<P, pSize>));
+		memcpy(&fitness[first], &population->fitness[first], count * sizeof(Fitness<F, fSize>));
+		memcpy(&violations[first], &population->violations[first], count * sizeof(ConstraintViolation<V, vSize>));
+	}
+
+	/**
+	 * @brief Operator that selects an individual based on its index in the population.
+	 *
+	 * The pointer to the actual view is returned, instead of a simple copy.
+	 *
+	 * @param i The index of the individual (index starts in zero).
+	 * @return A pointer to the Solution view of the individual.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* operator [](int i) {
+		if (i < 0 || i >= populationSize) {
+			throw std::invalid_argument(std::string("Invalid index for population [")
+										+ std::to_string(i) + "].");
+		}
+		return solutions[i];
+	}
+
+	/**
+	 * @brief Get the list of Solution views, one for every individual.
+	 *
+	 * The list is owned by this Population instance and must not be deleted.
+	 *
+	 * @return The list of Solution views.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>** getSolutions() {
+		return solutions;
+	}
+
+	/**
+	 * @brief Get a pointer to the contiguous block of Positions.
+	 *
+	 * The Positions of individual i start at index (i * {@link getNDimensions()}).
+	 *
+	 * @return The pointer to the first Position of the first individual.
+	 */
+	Position<P, pSize>* getPositions() {
+		return positions;
+	}
+
+	/**
+	 * @brief Get a pointer to the Fitness column.
+	 * @return The pointer to the Fitness of the first individual.
+	 */
+	Fitness<F, fSize>* getFitness() {
+		return fitness;
+	}
+
+	/**
+	 * @brief Get a pointer to the ConstraintViolation column.
+	 * @return The pointer to the ConstraintViolation of the first individual.
+	 */
+	ConstraintViolation<V, vSize>* getViolations() {
+		return violations;
+	}
+
+	int getPopulationSize() {
+		return populationSize;
+	}
+
+	int getNDimensions() {
+		return n;
+	}
+};
+
+#endif /* POPULATION_H_ */
@@ -29,27 +29,24 @@
  *          of same basic data type for all elements (eg., double or int).
  *          Therefore, to represent the entire search space,
  *          one Position object for every dimension is required.
+ *          The number of values is fixed by the template, so a Position holds the values only:
+ *          it is trivially copyable, and arrays of Positions are densely packed.
  */
 
 #ifndef POSITION_H_
 #define POSITION_H_
 
 #include <stdexcept>
-#include <string>
 
 template <class P = double, int pSize = 1>
 struct Position {
 	P internalPosition[pSize];
-	int size = pSize;
+	static constexpr int size = pSize;
 
 	void checkCompatibility(Position<P, pSize> *position) {
 		if(position == NULL) {
 			throw std::invalid_argument("Position can not be empty.");
 		}
-		if(size != position->size) {
-			throw std::invalid_argument(std::string("Position's internal sizes are not compatible [")
-										+ std::to_string(size) + " != " + std::to_string(position->size) + "].");
-		}
 	}
 
 public:
@@ -72,24 +69,13 @@ public:
 	 * @brief Operator that overrides the contents of this position with
 	 *        the contents of the Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void operator =(Position<P, pSize> *position){
 		checkCompatibility(position);
 		*this = position->internalPosition;
 	}
 
-	/**
-	 * @brief Operator that overrides the contents of this position with
-	 *        the contents of the Position instance received.
-	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
-	 */
-	void operator =(Position<P, pSize> &position){
-		checkCompatibility(&position);
-		*this = position.internalPosition;
-	}
-
 	/**
 	 * @brief Operator that assigns the same value to all elements of the list
 	 *        that represents the current Position.
@@ -173,7 +159,7 @@ public:
 	 * @brief Math method that sums the list that represents the Position
 	 *        with Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void sum(Position<P, pSize> *position) {
 		checkCompatibility(position);
@@ -184,7 +170,7 @@ public:
 	 * @brief Math method that sums the list that represents the Position
 	 *        with Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void sum(Position<P, pSize> &position) {
 		sum(&position);
@@ -222,7 +208,7 @@ public:
 	 * @brief Math method that subtracts the list that represents the Position
 	 *        from Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void sub(Position<P, pSize> *position) {
 		checkCompatibility(position);
@@ -233,7 +219,7 @@ public:
 	 * @brief Math method that subtracts the list that represents the Position
 	 *        from Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void sub(Position<P, pSize> &position) {
 		sub(&position);
@@ -274,7 +260,7 @@ public:
 	 * @brief Math method that multiplies the list that represents the Position
 	 *        with Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void mult(Position<P, pSize> *position) {
 		checkCompatibility(position);
@@ -285,7 +271,7 @@ public:
 	 * @brief Math method that multiplies the list that represents the Position
 	 *        with Position instance received.
 	 * @param position The source Position instance.
-	 * @throws invalid_argument if the source Position instance is not compatible with current position.
+	 * @throws invalid_argument if the source Position instance is empty.
 	 */
 	void mult(Position<P, pSize> &position) {
 		mult(&position);
@@ -413,4 +399,7 @@ public:
 	int getPositionSize() { return size; }
 };
 
+template <class P, int pSize>
+constexpr int Position<P, pSize>::size;
+
 #endif /* POSITION_H_ */
@@ -0,0 +1,371 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file RandomEngine.h
+ * @class RandomEngine
+ * @author Peter Frank Perroni
+ * @brief Fast pseudo-random number engines and samplers.
+ * @details Three engines are provided, all of them small enough to be owned by every thread:
+ *          - Xoshiro256pp: xoshiro256++ (256 bits of state), with jump-ahead for non-overlapping streams;
+ *          - Pcg32: PCG-XSH-RR (64 bits of state), with 2^63 selectable streams;
+ *          - CounterEngine: counter-based generator (SplitMix64 output function applied to key + counter),
+ *            whose n-th number can be obtained directly, which makes parallel runs reproducible
+ *            regardless of how the work is split among threads or processes.
+ *
+ *          The RandomEngine template adds the samplers (uniform, normal, gamma and beta,
+ *          as well as the bulk generation into buffers) on top of any of these engines.
+ *          The default engine used by TH (THRandomEngine) is selected through RANDENGINE (see config.h).
+ */
+
+#ifndef RANDOMENGINE_H_
+#define RANDOMENGINE_H_
+
+#include "macros.h"
+#include "config.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <stdint.h>
+
+/**
+ * @brief SplitMix64 generator, mainly used to expand a single seed into the state of other engines.
+ */
+struct SplitMix64 {
+	uint64_t state;
+
+	SplitMix64(uint64_t seed) : state(seed) {}
+
+	/**
+	 * @brief The SplitMix64 output function (a strong 64-bit mixer).
+	 */
+	static inline uint64_t mix(uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	inline uint64_t next() {
+		return mix(state += 0x9E3779B97F4A7C15ULL);
+	}
+};
+
+/**
+ * @brief xoshiro256++ engine (Blackman and Vigna).
+ */
+struct Xoshiro256pp {
+	uint64_t s[4];
+
+	static inline uint64_t rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	Xoshiro256pp(uint64_t seed = 1) {
+		this->seed(seed);
+	}
+
+	void seed(uint64_t seed) {
+		SplitMix64 sm(seed);
+		for(int i=0; i < 4; i++) s[i] = sm.next();
+	}
+
+	inline uint64_t next() {
+		const uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	/**
+	 * @brief Advance the engine by 2^128 numbers, creating a non-overlapping sub-sequence.
+	 */
+	void jump() {
+		static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+		uint64_t t[4] = {0, 0, 0, 0};
+		for(int i=0; i < 4; i++) {
+			for(int b=0; b < 64; b++) {
+				if(JUMP[i] & (1ULL << b)) {
+					for(int k=0; k < 4; k++) t[k] ^= s[k];
+				}
+				next();
+			}
+		}
+		for(int k=0; k < 4; k++) s[k] = t[k];
+	}
+
+	/**
+	 * @brief Create the engine for an independent stream.
+	 * @param seed The seed shared by all streams.
+	 * @param stream The stream index (the stream is obtained by jumping 'stream' times).
+	 * @return The engine positioned at the beginning of the stream.
+	 */
+	static Xoshiro256pp forStream(uint64_t seed, uint64_t stream) {
+		Xoshiro256pp engine(seed);
+		for(uint64_t i=0; i < stream; i++) engine.jump();
+		return engine;
+	}
+};
+
+/**
+ * @brief PCG32 engine (O'Neill), XSH-RR output function over a 64-bit LCG.
+ */
+struct Pcg32 {
+	uint64_t state;
+	uint64_t inc;
+
+	Pcg32(uint64_t seed = 1, uint64_t stream = 0) {
+		this->seed(seed, stream);
+	}
+
+	void seed(uint64_t seed, uint64_t stream = 0) {
+		state = 0;
+		inc = (stream << 1) | 1;
+		next32();
+		state += seed;
+		next32();
+	}
+
+	inline uint32_t next32() {
+		uint64_t old = state;
+		state = old * 6364136223846793005ULL + inc;
+		uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+		uint32_t rot = (uint32_t)(old >> 59);
+		return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+	}
+
+	inline uint64_t next() {
+		uint64_t hi = next32();
+		return (hi << 32) | next32();
+	}
+
+	/**
+	 * @brief Create the engine for an independent stream.
+	 * @param seed The seed shared by all streams.
+	 * @param stream The stream index (PCG32 natively supports 2^63 streams).
+	 * @return The engine positioned at the beginning of the stream.
+	 */
+	static Pcg32 forStream(uint64_t seed, uint64_t stream) {
+		return Pcg32(seed, stream);
+	}
+};
+
+/**
+ * @brief Counter-based engine: the i-th number of a stream is mix(key + i * golden ratio).
+ *
+ * Since any position can be reached in O(1) (see {@link seek()}), the numbers consumed by
+ * every individual (or dimension, iteration, etc) can be tied to a fixed counter,
+ * producing the same results no matter how the work is distributed.
+ */
+struct CounterEngine {
+	uint64_t key;
+	uint64_t counter;
+
+	CounterEngine(uint64_t seed = 1, uint64_t stream = 0) {
+		key = SplitMix64::mix(seed ^ SplitMix64::mix(stream + 0x632BE59BD9B4E019ULL));
+		counter = 0;
+	}
+
+	inline uint64_t next() {
+		return at(counter++);
+	}
+
+	/**
+	 * @brief Get the number at a given position of the stream, without changing the engine state.
+	 * @param position The position in the stream.
+	 * @return The random number.
+	 */
+	inline uint64_t at(uint64_t position) const {
+		return SplitMix64::mix(key + (position + 1) * 0x9E3779B97F4A7C15ULL);
+	}
+
+	/**
+	 * @brief Move the engine to a given position of the stream.
+	 * @param position The position in the stream.
+	 */
+	void seek(uint64_t position) {
+		counter = position;
+	}
+
+	static CounterEngine forStream(uint64_t seed, uint64_t stream) {
+		return CounterEngine(seed, stream);
+	}
+};
+
+/**
+ * @brief Samplers on top of an engine.
+ *
+ * Every instance must be used by one single thread at a time.
+ */
+template <class Engine = Xoshiro256pp>
+class RandomEngine : public Engine {
+	static constexpr double TWO_POW_MINUS_53 = 1.0 / 9007199254740992.0;
+	double spareNormal;
+	bool hasSpareNormal;
+
+public:
+	RandomEngine(uint64_t seed = 1) : Engine(seed) {
+		hasSpareNormal = false;
+		spareNormal = 0;
+	}
+
+	RandomEngine(const Engine &engine) : Engine(engine) {
+		hasSpareNormal = false;
+		spareNormal = 0;
+	}
+
+	/**
+	 * @brief Create the sampler for an independent stream (see the engine's forStream()).
+	 * @param seed The seed shared by all streams.
+	 * @param stream The stream index.
+	 * @return The sampler positioned at the beginning of the stream.
+	 */
+	static RandomEngine<Engine> forStream(uint64_t seed, uint64_t stream) {
+		return RandomEngine<Engine>(Engine::forStream(seed, stream));
+	}
+
+	/**
+	 * @brief Get a uniform random number in [0, 1[, with 53 bits of precision.
+	 */
+	inline double nextDouble() {
+		return (this->next() >> 11) * TWO_POW_MINUS_53;
+	}
+
+	/**
+	 * @brief Get a uniform random number in [a, b[.
+	 */
+	inline double uniform(double a, double b) {
+		return a + nextDouble() * (b - a);
+	}
+
+	/**
+	 * @brief Get a uniform random integer in [a, b].
+	 */
+	inline int uniformInt(int a, int b) {
+		return a + (int)(nextDouble() * ((double)b - a + 1));
+	}
+
+	/**
+	 * @brief Get a normal random number (Marsaglia's polar method).
+	 *
+	 * Every pair of numbers generated by the polar method is used (the second one is cached).
+	 *
+	 * @param mean The mean of the distribution.
+	 * @param stdDev The standard deviation of the distribution.
+	 */
+	double normal(double mean = 0, double stdDev = 1) {
+		if(hasSpareNormal) {
+			hasSpareNormal = false;
+			return mean + stdDev * spareNormal;
+		}
+		double u, v, s;
+		do {
+			u = 2 * nextDouble() - 1;
+			v = 2 * nextDouble() - 1;
+			s = u*u + v*v;
+		} while(s >= 1 || s == 0);
+		s = std::sqrt(-2 * std::log(s) / s);
+		spareNormal = v * s;
+		hasSpareNormal = true;
+		return mean + stdDev * u * s;
+	}
+
+	/**
+	 * @brief Get a Gamma(alpha, 1) random number (Marsaglia and Tsang's method).
+	 * @param alpha The shape of the distribution (must be positive).
+	 */
+	double gamma(double alpha) {
+		if(alpha <= 0) throw std::invalid_argument("The shape of the gamma distribution must be positive.");
+		if(alpha < 1) {
+			// Gamma(alpha) = Gamma(alpha+1) * U^(1/alpha).
+			double u;
+			do { u = nextDouble(); } while(u == 0);
+			return gamma(alpha + 1) * std::pow(u, 1 / alpha);
+		}
+		const double d = alpha - 1.0 / 3, c = 1 / std::sqrt(9 * d);
+		double x, v, u;
+		while(true) {
+			do {
+				x = normal();
+				v = 1 + c * x;
+			} while(v <= 0);
+			v = v * v * v;
+			u = nextDouble();
+			if(u < 1 - 0.0331 * (x*x) * (x*x)) return d * v;
+			if(u > 0 && std::log(u) < 0.5 * x*x + d * (1 - v + std::log(v))) return d * v;
+		}
+	}
+
+	/**
+	 * @brief Get a Beta(alpha, beta) random number, through the ratio of two gamma numbers.
+	 * @param alpha The first shape of the distribution (must be positive).
+	 * @param beta The second shape of the distribution (must be positive).
+	 */
+	double beta(double alpha, double beta) {
+		double x = gamma(alpha);
+		double y = this->gamma(beta);
+		return (x + y > 0) ? x / (x + y) : 0.5;
+	}
+
+	/**
+	 * @brief Fill a buffer with uniform random numbers in [a, b[.
+	 */
+	void fillUniform(double *buffer, long size, double a, double b) {
+		const double range = b - a;
+		for(long i=0; i < size; i++) {
+			buffer[i] = a + ((this->next() >> 11) * TWO_POW_MINUS_53) * range;
+		}
+	}
+
+	/**
+	 * @brief Fill a buffer with normal random numbers.
+	 */
+	void fillNormal(double *buffer, long size, double mean = 0, double stdDev = 1) {
+		for(long i=0; i < size; i++) {
+			buffer[i] = normal(mean, stdDev);
+		}
+	}
+
+	/**
+	 * @brief Fill a buffer with Beta(alpha, beta) random numbers.
+	 */
+	void fillBeta(double *buffer, long size, double alpha, double beta) {
+		for(long i=0; i < size; i++) {
+			buffer[i] = this->beta(alpha, beta);
+		}
+	}
+};
+
+#ifndef RANDENGINE
+#define RANDENGINE RANDENGINE_XOSHIRO256PP
+#endif
+
+#if RANDENGINE == RANDENGINE_PCG32
+typedef RandomEngine<Pcg32> THRandomEngine;
+#elif RANDENGINE == RANDENGINE_COUNTER
+typedef RandomEngine<CounterEngine> THRandomEngine;
+#else
+typedef RandomEngine<Xoshiro256pp> THRandomEngine;
+#endif
+
+#endif /* RANDOMENGINE_H_ */
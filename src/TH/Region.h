@@ -33,6 +33,9 @@
 #include "Dimension.h"
 #include "Partition.h"
 #include <map>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <cstdlib>
 #include <sstream>
 #include <iostream>
@@ -41,29 +44,58 @@ using namespace std;
 
 template<class P = double>
 class Region {
-	map<Dimension<P>*, Partition<P>*> *partitions;
-	map<int, Dimension<P>* > *dimensions;
+	Dimension<P> *dimensions;	// Indexed by dimension ID.
+	Partition<P> *partitions;	// Indexed by dimension ID.
+	int n;
+	map<Dimension<P>*, Partition<P>*> *partitionMap;
+	map<int, Dimension<P>* > *dimensionMap;
+
+	void allocate(int nDimensions) {
+		n = nDimensions;
+		dimensions = (Dimension<P>*) ::operator new(n * sizeof(Dimension<P>));
+		partitions = (Partition<P>*) ::operator new(n * sizeof(Partition<P>));
+		partitionMap = NULL;
+		dimensionMap = NULL;
+	}
 
 	void setup(map<Dimension<P>*, Partition<P>*> *partitions) {
 		if(partitions == NULL || partitions->size() == 0) {
 			throw std::invalid_argument("The partitions that compose a region cannot be empty.");
 		}
-		dimensions = new map<int, Dimension<P>*>();
-		this->partitions = new map<Dimension <P>*, Partition <P>*>();
-		Dimension<P> *dim;
-		Partition<P> *part;
+		allocate(partitions->size());
+		bool *assigned = new bool[n]();
 		for(auto elem = partitions->begin(); elem != partitions->end(); ++elem) {
-			dim = new Dimension<P>(elem->first);
-			part = new Partition<P>(elem->second);
-			this->dimensions->insert({dim->getID(), dim});
-			this->partitions->insert({dim, part});
+			int ID = elem->first->getID();
+			if(ID < 0 || ID >= n || assigned[ID]) {
+				delete[] assigned;
+				::operator delete(this->dimensions);
+				::operator delete(this->partitions);
+				throw std::invalid_argument(std::string("The dimension IDs must be unique and sequential in [0, ")
+						+ std::to_string(n) + "[ (found " + std::to_string(ID) + ").");
+			}
+			assigned[ID] = true;
+			new (&this->dimensions[ID]) Dimension<P>(elem->first);
+			new (&this->partitions[ID]) Partition<P>(elem->second);
+		}
+		delete[] assigned;
+	}
+
+	void setup(Region<P> *region) {
+		allocate(region->n);
+		for(int i=0; i < n; i++) {
+			new (&dimensions[i]) Dimension<P>(&region->dimensions[i]);
+			new (&partitions[i]) Partition<P>(&region->partitions[i]);
 		}
 	}
 
 public:
 	/**
 	 * @brief This construction creates a Region by copying the contents of the map provided.
+	 *
+	 * The dimension IDs must be sequential in the interval [0, n[, where n is the number of dimensions.
+	 *
 	 * @param partitions The source map.
+	 * @throws invalid_argument if the dimension IDs are not unique and sequential.
 	 */
 	Region(map<Dimension<P>*, Partition<P>*> *partitions) { // @suppress("Class members should be properly initialized")
 		setup(partitions);
@@ -77,15 +109,33 @@ public:
 		if(region == NULL) {
 			throw std::invalid_argument("A region cannot be created based on an empty region.");
 		}
-		setup(region->partitions);
+		setup(region);
 	}
 	~Region(){
-		for(auto elem = partitions->begin(); elem != partitions->end(); ++elem) {
-			delete elem->first;
-			delete elem->second;
+		::operator delete(dimensions);
+		::operator delete(partitions);
+		if(partitionMap != NULL) delete partitionMap;
+		if(dimensionMap != NULL) delete dimensionMap;
+	}
+
+	/**
+	 * @brief Operator that overrides the boundaries of this Region with
+	 *        the boundaries of the Region received.
+	 *
+	 * No memory is allocated, so it can be used to cheaply reuse a working Region.
+	 *
+	 * @param region The source Region instance.
+	 * @throws invalid_argument if the source Region has a different number of dimensions.
+	 */
+	void operator =(Region<P> *region) {
+		if(region == NULL || region->n != n) {
+			throw std::invalid_argument("The regions must have the same number of dimensions.");
+		}
+		if(this == region) return;
+		for(int i=0; i < n; i++) {
+			dimensions[i] = region->dimensions[i];
+			partitions[i] = region->partitions[i];
 		}
-		delete partitions;
-		delete dimensions;
 	}
 
 	/**
@@ -94,27 +144,27 @@ public:
 	 * The pointer to the actual object is returned, instead of a simple copy.
 	 *
 	 * @param i The index of the Dimension (index starts in zero).
-	 * @return A pointer to the Partition selected.
+	 * @return A pointer to the Partition selected, or NULL if the index is invalid.
 	 */
 	Partition<P>* operator [](int i) {
-		Dimension<P> *dim = getOriginalDimension(i);
-		if(dim != NULL) {
-			typename map<Dimension <P>*, Partition<P>*>::iterator itP = partitions->find(dim);
-			if(itP != partitions->end()) return itP->second;
-		}
-		return NULL;
+		return (i >= 0 && i < n) ? &partitions[i] : NULL;
 	}
 
 	/**
 	 * @brief Obtains a pointer to the map containing the dimensions
 	 *        that compose the entire search space.
 	 *
-	 * The pointer to the actual object is returned, instead of a simple copy.
+	 * The map is built on the first call and points to the actual objects.
+	 * Prefer {@link getOriginalDimension()}, which does not require any lookup.
 	 *
 	 * @return A pointer to the map containing the dimensions for entire search space.
 	 */
 	map<int, Dimension<P>*>* getOriginalDimensions(){
-		return dimensions;
+		if(dimensionMap == NULL) {
+			dimensionMap = new map<int, Dimension<P>*>();
+			for(int i=0; i < n; i++) dimensionMap->insert({i, &dimensions[i]});
+		}
+		return dimensionMap;
 	}
 
 	/**
@@ -123,33 +173,50 @@ public:
 	 * The pointer to the actual object is returned, instead of a simple copy.
 	 *
 	 * @param i The index of the Dimension (index starts in zero).
-	 * @return A pointer to the Dimension selected.
+	 * @return A pointer to the Dimension selected, or NULL if the index is invalid.
 	 */
 	Dimension<P>* getOriginalDimension(int i){
-		typename map<int, Dimension<P>*>::iterator itD = dimensions->find(i);
-		if(itD != dimensions->end()) {
-			return itD->second;
-		}
-		return NULL;
+		return (i >= 0 && i < n) ? &dimensions[i] : NULL;
 	}
 
 	/**
 	 * @brief Get the map of Partitions that compose the current "anchor" sub-region.
 	 *
-	 * The pointer to the actual object is returned, instead of a simple copy.
+	 * The map is built on the first call and points to the actual objects.
+	 * Prefer {@link operator[]}, which does not require any lookup.
 	 *
 	 * @return The map that compose the current "anchor" sub-region.
 	 */
 	map<Dimension <P>*, Partition <P>*>* getPartitions(){
+		if(partitionMap == NULL) {
+			partitionMap = new map<Dimension<P>*, Partition<P>*>();
+			for(int i=0; i < n; i++) partitionMap->insert({&dimensions[i], &partitions[i]});
+		}
+		return partitionMap;
+	}
+
+	/**
+	 * @brief Get the contiguous list of Partitions, indexed by dimension ID.
+	 * @return The pointer to the Partition of the first dimension.
+	 */
+	Partition<P>* getPartitionList(){
 		return partitions;
 	}
 
+	/**
+	 * @brief Get the contiguous list of the full search space's Dimensions, indexed by dimension ID.
+	 * @return The pointer to the first Dimension.
+	 */
+	Dimension<P>* getDimensionList(){
+		return dimensions;
+	}
+
 	/**
 	 * @brief Get the number of dimensions of this region.
 	 * @return The number of dimensions of this region.
 	 */
 	int getNDimensions() {
-		return (dimensions!=NULL) ? dimensions->size() : 0;
+		return n;
 	}
 
 	/**
@@ -160,12 +227,12 @@ public:
 		Partition <P> *partition;
 		std::stringstream ss;
 		ss << "[ ";
-		for(auto elem = partitions->begin(); elem != partitions->end(); ) {
-			dim = elem->first;
-			partition = elem->second;
+		for(int i=0; i < n; i++) {
+			dim = &dimensions[i];
+			partition = &partitions[i];
 			ss << "{ {" << dim->getID() << ", " << dim->getStartPoint() << ", " << dim->getEndPoint() << "}, "
 					<< "{" << partition->getID() << ", " << partition->getStartPoint() << ", " << partition->getEndPoint() << "} }"
-					<< (++elem != partitions->end() ? ", ": " ") << std::endl;
+					<< (i+1 < n ? ", ": " ") << std::endl;
 		}
 		ss << "]";
 		std::cout << ss.str().c_str() << std::endl;
@@ -58,6 +58,18 @@ public:
 	 */
 	virtual Region<P>* apply(SearchSpace<P> *S, THTree *tree, int ID) = 0;
 
+	/**
+	 * @brief Get the number of child positions (see {@link THTree::getChildPosition()})
+	 *        that the policy can map to distinct sub-regions.
+	 *
+	 * By default, the number of positions is not bounded.
+	 *
+	 * @return The number of child positions, or -1 if not bounded.
+	 */
+	virtual long long getNChildPositions() {
+		return -1;
+	}
+
 	/**
 	 * @brief This method can be used by sub-classes to obtain a dynamic region
 	 *        at every TH iteration.
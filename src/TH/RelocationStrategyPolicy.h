@@ -29,11 +29,19 @@
 #define RELOCATIONSTRATEGYPOLICY_H_
 
 #include "RelocationStrategyData.h"
+#include "Population.h"
+#include "ThreadPool.h"
+
+#include <stdexcept>
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class RelocationStrategyPolicy {
+	ThreadPool *threadPool;
+
 public:
-	RelocationStrategyPolicy() {}
+	RelocationStrategyPolicy() {
+		threadPool = NULL;
+	}
 	virtual ~RelocationStrategyPolicy() {}
 
 	/**
@@ -55,6 +63,55 @@ public:
 			Region<P> *region,
 			Solution<P, pSize, F, fSize, V, vSize> **population,
 			int populationSize) = 0;
+
+	/**
+	 * @brief Allocate ahead the buffers required by the policy, so that the relocations
+	 *        do not allocate memory.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * @param populationSize The largest population size to be relocated.
+	 * @param nDimensions The number of dimensions of the individuals.
+	 */
+	virtual void reserve(int populationSize, int nDimensions) {}
+
+	/**
+	 * @brief Set the pool of threads used to relocate the population in parallel.
+	 *
+	 * The pool is owned by the TH framework, which sets it when more than one
+	 * thread is configured (see {@link THBuilder::setNThreads()}). Policies that draw
+	 * random numbers in parallel must use one stream per worker
+	 * (see {@link ThreadPool::getSeed()}), so the relocation stays reproducible.
+	 *
+	 * @param threadPool The thread pool, or NULL to relocate sequentially.
+	 */
+	virtual void setThreadPool(ThreadPool *threadPool) {
+		this->threadPool = threadPool;
+	}
+
+	ThreadPool* getThreadPool() {
+		return threadPool;
+	}
+
+	/**
+	 * @brief Apply the relocation strategy to the tail of a contiguous population.
+	 *
+	 * Convenience method that relocates the individuals [from, populationSize[
+	 * of the population through {@link apply()}.
+	 *
+	 * @param relocationStrategyData The repository containing useful data to perform the relocation.
+	 * @param region The "anchor" Region for current TH instance.
+	 * @param population The contiguous population.
+	 * @param from The index of the first individual to relocate.
+	 */
+	void applyRange(RelocationStrategyData<P, pSize, F, fSize, V, vSize> *relocationStrategyData,
+			Region<P> *region,
+			Population<P, pSize, F, fSize, V, vSize> *population,
+			int from) {
+		if(population == NULL) throw std::invalid_argument("The population cannot be empty.");
+		if(from < 0 || from >= population->getPopulationSize()) return;
+		apply(relocationStrategyData, region, &population->getSolutions()[from], population->getPopulationSize() - from);
+	}
 };
 
 #endif /* RELOCATIONSTRATEGYPOLICY_H_ */
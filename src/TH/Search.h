@@ -33,23 +33,35 @@
 #define SEARCH_H_
 
 #include "FitnessPolicy.h"
+#include "Population.h"
 #include "SearchSpace.h"
 
 #include <mpi.h>
+#include <chrono>
 
 template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class Search {
 	FitnessPolicy<P, pSize, F, fSize, V, vSize> *fitnessPolicy;
 	Solution<P, pSize, F, fSize, V, vSize> **population;
+	Population<P, pSize, F, fSize, V, vSize> *populationStore;
 	SearchSpace<P> *searchSpace;
 	int preferredPopulationSize;
 	int populationSize;
+	std::chrono::steady_clock::time_point deadline;
 
 protected:
 	Solution<P, pSize, F, fSize, V, vSize>** getPopulation(){
 		return population;
 	}
 
+	/**
+	 * @brief Get the contiguous storage of the population.
+	 * @return The Population instance, or NULL if the population was set as a plain list of Solutions.
+	 */
+	Population<P, pSize, F, fSize, V, vSize>* getPopulationStore(){
+		return populationStore;
+	}
+
 public:
 	/**
 	 * @brief Constructor to create a Search instance.
@@ -59,8 +71,10 @@ public:
 		this->preferredPopulationSize = preferredPopulationSize;
 		fitnessPolicy = NULL;
 		population =  NULL;
+		populationStore = NULL;
 		searchSpace = NULL;
 		populationSize = 0;
+		deadline = std::chrono::steady_clock::time_point::max();
 	}
 	virtual ~Search() {}
 
@@ -79,6 +93,21 @@ public:
 	void setPopulation(Solution<P, pSize, F, fSize, V, vSize> **population, int populationSize){
 		this->population = population;
 		this->populationSize = populationSize;
+		populationStore = NULL;
+	}
+
+	/**
+	 * @brief Set the population from its contiguous storage.
+	 *
+	 * Same as {@link setPopulation(Solution**, int)}, but also gives the search algorithm
+	 * access to the contiguous blocks of Positions, Fitness and ConstraintViolation.
+	 *
+	 * @param population The actual population.
+	 */
+	void setPopulation(Population<P, pSize, F, fSize, V, vSize> *population){
+		if(population == NULL) throw std::invalid_argument("The population cannot be empty.");
+		setPopulation(population->getSolutions(), population->getPopulationSize());
+		populationStore = population;
 	}
 
 	int getPreferredPopulationSize() {
@@ -128,6 +157,17 @@ public:
 	 */
 	virtual void startup()=0;
 
+	/**
+	 * @brief Allocate ahead the buffers required by the optimization method, so that
+	 *        the optimizations do not allocate memory (see {@link TH::getSteadyStateAllocations()}).
+	 *
+	 * The default implementation does nothing. The implementations must also be able to
+	 * allocate their buffers in startup(), in case this method has not been called.
+	 *
+	 * @param populationSize The largest population size to be optimized.
+	 */
+	virtual void reserve(int populationSize) {}
+
 	/**
 	 * @brief Method responsible for all post-processing after the optimization has completed.
 	 *
@@ -155,10 +195,37 @@ public:
 	 * Notice that the best result for the starting population should be evaluated at
 	 * the startup() method.
 	 *
+	 * Implementations should also stop once the deadline has passed (see {@link isTimeUp()}),
+	 * checking it at least once per pass over the population.
+	 *
 	 * @param M The maximum number of evaluations allowed to obtain the next improvement.
 	 */
 	virtual void next(int M)=0;
 
+	/**
+	 * @brief Set the moment the optimization must stop, regardless of the evaluations left.
+	 *
+	 * The deadline is set by the ConvergenceControlPolicy (and by TH, for the local search),
+	 * so that a slow fitness function cannot overrun the time allowed.
+	 *
+	 * @param deadline The deadline, or time_point::max() for no deadline (default).
+	 */
+	void setDeadline(std::chrono::steady_clock::time_point deadline) {
+		this->deadline = deadline;
+	}
+
+	std::chrono::steady_clock::time_point getDeadline() {
+		return deadline;
+	}
+
+	/**
+	 * @brief Check if the deadline has passed.
+	 */
+	bool isTimeUp() {
+		return deadline != std::chrono::steady_clock::time_point::max()
+				&& std::chrono::steady_clock::now() >= deadline;
+	}
+
 	/**
 	 * @brief Inform the ConvergenceControlPolicy that no next improvement could be found
 	 *        in reasonable time.
@@ -175,6 +242,24 @@ public:
 	 */
 	virtual bool isStuck()=0;
 
+	/**
+	 * @brief Insert an external Solution (e.g. received from another TH instance) into
+	 *        the running optimization.
+	 *
+	 * This method is called between two consecutive calls to {@link next(int)}, so that a
+	 * better Solution found elsewhere can take part in the optimization without waiting
+	 * for the current iteration to complete. The immigrant is already evaluated, and must
+	 * be copied (it is not owned by the search algorithm).
+	 *
+	 * The default implementation ignores the immigrant.
+	 *
+	 * @param immigrant The Solution to be inserted.
+	 * @return True if the immigrant has been inserted into the population. False otherwise.
+	 */
+	virtual bool injectImmigrant(Solution<P, pSize, F, fSize, V, vSize> *immigrant) {
+		return false;
+	}
+
 	/**
 	 * @brief Get the best Solution found since the last time the method startup() was called.
 	 *
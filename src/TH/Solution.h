@@ -36,22 +36,39 @@
 #include "THUtil.h"
 
 #include <mpi.h>
+#include <new>
 #include <stddef.h>
 #include <stdexcept>
 #include <string>
+#include <string.h>
+#include <type_traits>
 
 template<class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
 class Solution {
+	// The positions, fitness and violations are copied as raw memory.
+	static_assert(std::is_trivially_copyable<Position<P, pSize> >::value
+			&& std::is_trivially_copyable<Fitness<F, fSize> >::value
+			&& std::is_trivially_copyable<ConstraintViolation<V, vSize> >::value,
+			"Position, Fitness and ConstraintViolation must be trivially copyable.");
+	static_assert(sizeof(Position<P, pSize>) == pSize * sizeof(P), "The Positions must be densely packed.");
+
 	Position<P, pSize> *positions;
-	Fitness<F, fSize> fitness;
-	ConstraintViolation<V, vSize> violation;
+	Fitness<F, fSize> *fitness;
+	ConstraintViolation<V, vSize> *violation;
+	Fitness<F, fSize> localFitness;
+	ConstraintViolation<V, vSize> localViolation;
 	int n;
 	unsigned int seed;
+	bool ownsStorage;
 
 	void setup(int nDimensions) {
 		if (nDimensions <= 0) throw std::invalid_argument("The number of dimensions must be greater than zero.");
 		n = nDimensions;
-		positions = new Position<P, pSize>[n];
+		positions = (Position<P, pSize>*) THUtil::alignedAlloc(n * sizeof(Position<P, pSize>));
+		for (int i = 0; i < n; i++) new (&positions[i]) Position<P, pSize>();
+		fitness = &localFitness;
+		violation = &localViolation;
+		ownsStorage = true;
 		seed = THUtil::getRandomSeed();
 	}
 
@@ -84,8 +101,33 @@ public:
 		setup(solution->getNDimensions());
 		*this = solution;
 	}
+
+	/**
+	 * @brief This constructor creates a Solution instance as a view over an external storage.
+	 *
+	 * No memory is allocated for the positions, fitness or violation, which remain owned by
+	 * the caller (usually a {@link Population}) and must outlive this Solution instance.
+	 *
+	 * @param nDimensions The number of dimensions this solution contains.
+	 * @param positions The storage for the nDimensions positions of this solution.
+	 * @param fitness The storage for the fitness of this solution.
+	 * @param violation The storage for the constraint violations of this solution.
+	 */
+	Solution(int nDimensions, Position<P, pSize> *positions, Fitness<F, fSize> *fitness, // @suppress("Class members should be properly initialized")
+			ConstraintViolation<V, vSize> *violation) {
+		if (nDimensions <= 0) throw std::invalid_argument("The number of dimensions must be greater than zero.");
+		if (positions == NULL || fitness == NULL || violation == NULL) {
+			throw std::invalid_argument("The storage of a Solution view cannot be empty.");
+		}
+		n = nDimensions;
+		this->positions = positions;
+		this->fitness = fitness;
+		this->violation = violation;
+		ownsStorage = false;
+		seed = THUtil::getRandomSeed();
+	}
 	~Solution() {
-		delete positions;
+		if (ownsStorage) THUtil::alignedFree(positions);
 	}
 
 	/**
@@ -98,9 +140,7 @@ public:
 	 */
 	void operator =(P *buffer) {
 		if (buffer == NULL) return;
-		for (int i=0, ptr=0; i < n; i++, ptr+=pSize) {
-			positions[i] = &buffer[ptr];
-		}
+		memcpy(positions, buffer, n * sizeof(Position<P, pSize>));
 	}
 
 	/**
@@ -113,11 +153,10 @@ public:
 	void operator =(Solution<P, pSize, F, fSize, V, vSize> *solution) {
 		checkCompatibility(solution);
 		this->n = solution->n;
-		for (int i = 0; i < solution->n; i++) {
-			this->positions[i] = solution->positions[i];
-		}
-		this->fitness = solution->fitness;
-		this->violation = solution->violation;
+		if (this == solution) return;
+		memcpy(this->positions, solution->positions, n * sizeof(Position<P, pSize>));
+		*this->fitness = *solution->fitness;
+		*this->violation = *solution->violation;
 	}
 
 	void operator =(Solution<P, pSize, F, fSize, V, vSize> &solution) {
@@ -137,8 +176,8 @@ public:
 		for (int i = 0; i < solution->n; i++) {
 			if (this->positions[i] != solution->positions[i]) return false;
 		}
-		if (this->fitness != solution->fitness) return false;
-		if (this->violation != solution->violation) return false;
+		if (*this->fitness != solution->fitness) return false;
+		if (*this->violation != solution->violation) return false;
 		return true;
 	}
 	bool operator ==(Solution<P, pSize, F, fSize, V, vSize> *solution) {
@@ -182,6 +221,18 @@ public:
 		return &positions[i];
 	}
 
+	/**
+	 * @brief Get a pointer to the contiguous list of Positions of this Solution.
+	 *
+	 * The pointer to the actual storage is returned, instead of a simple copy.
+	 * The list contains {@link getNDimensions()} Positions.
+	 *
+	 * @return The pointer to the first Position of this Solution.
+	 */
+	Position<P, pSize>* getInternalPositions() {
+		return positions;
+	}
+
 	/**
 	 * @brief This method copies the contents of current Position to the
 	 *        buffer received.
@@ -192,9 +243,7 @@ public:
 	 */
 	void getPositions(P *buffer) {
 		if (buffer == NULL) return;
-		for (int i = 0, ptr = 0; i < n; i++, ptr+=pSize) {
-			positions[i].getInternalPosition(&buffer[ptr]);
-		}
+		memcpy(buffer, positions, n * sizeof(Position<P, pSize>));
 	}
 
 	/**
@@ -202,7 +251,7 @@ public:
 	 * @return The pointer to the Fitness instance.
 	 */
 	Fitness<F, fSize>* getFitness() {
-		return &fitness;
+		return fitness;
 	}
 
 	/**
@@ -215,7 +264,7 @@ public:
 	 */
 	void getFitness(F *buffer) {
 		if (buffer == NULL) return;
-		fitness.getInternalFitness(buffer);
+		fitness->getInternalFitness(buffer);
 	}
 
 	/**
@@ -227,7 +276,7 @@ public:
 	 * @param buffer The source buffer.
 	 */
 	void setFitness(F *buffer) {
-		this->fitness = buffer;
+		*this->fitness = buffer;
 	}
 
 	/**
@@ -235,7 +284,7 @@ public:
 	 * @param value The value to assign to the Fitness instance.
 	 */
 	void setFitness(F value) {
-		this->fitness = value;
+		*this->fitness = value;
 	}
 
 	/**
@@ -243,7 +292,7 @@ public:
 	 * @return The pointer to the ConstraintViolation instance.
 	 */
 	ConstraintViolation<V, vSize>* getViolation() {
-		return &violation;
+		return violation;
 	}
 
 	/**
@@ -256,7 +305,7 @@ public:
 	 */
 	void getViolation(V *buffer) {
 		if (buffer == NULL) return;
-		fitness.getInternalViolation(buffer);
+		violation->getInternalViolation(buffer);
 	}
 
 	/**
@@ -268,7 +317,7 @@ public:
 	 * @param buffer The source buffer.
 	 */
 	void setViolation(V *buffer) {
-		this->violation = buffer;
+		*this->violation = buffer;
 	}
 
 	/**
@@ -276,7 +325,7 @@ public:
 	 * @param value The value to assign to the ConstraintViolation instance.
 	 */
 	void setViolation(F value) {
-		this->violation = value;
+		*this->violation = value;
 	}
 
 	/**
@@ -293,17 +342,15 @@ public:
 	 */
 	void reset(Region<P> *r, Solution<P, pSize, F, fSize, V, vSize> *bias = NULL) {
 		if (r == NULL) throw std::invalid_argument("Region cannot be null.");
-		map<int, Dimension<P>*> *originalDimensions = r->getOriginalDimensions();
-		if (n != (int) originalDimensions->size()) {
+		if (n != r->getNDimensions()) {
 			throw std::invalid_argument("The number of dimensions does not match.");
 		}
 
-		map<Dimension<P>*, Partition<P>*> *partitions = r->getPartitions();
+		Partition<P> *partitions = r->getPartitionList(); // Indexed by dimension ID.
 		Partition<P> *partition;
 		Position<P, pSize> *pos;
 		for (int i = 0; i < n; i++) {
-			// Use originalDimensions to map the correct sequence of dimensions on partitions.
-			partition = (*partitions)[(*originalDimensions)[i]];
+			partition = &partitions[i];
 			if(bias != NULL) { // If a bias is provided.
 				pos = (*bias)[i];
 				if(THUtil::randUniformDouble(seed, 0, 1) < 0.5) { // For half of the dimensions:
@@ -329,6 +376,15 @@ public:
 	int getNDimensions() {
 		return n;
 	}
+
+	/**
+	 * @brief Inform if this Solution instance is a view over an external storage.
+	 * @return True if the storage is owned by another object (eg. a Population).
+	 *         False if this Solution instance owns its storage.
+	 */
+	bool isView() {
+		return !ownsStorage;
+	}
 };
 
 #endif /* SOLUTION_H_ */
@@ -0,0 +1,128 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file SolutionPool.h
+ * @class SolutionPool
+ * @author Peter Frank Perroni
+ * @brief Fixed-capacity arena of Solutions.
+ * @details All Solutions of the pool are views into one single Population (i.e. one contiguous
+ *          block of memory allocated at construction), and are handed out and taken back
+ *          through a free list. Acquiring and releasing Solutions never touches the heap,
+ *          so the pool can back the Solutions created and discarded during the TH iterations.
+ */
+
+#ifndef SOLUTIONPOOL_H_
+#define SOLUTIONPOOL_H_
+
+#include "Population.h"
+
+#include <new>
+#include <stdexcept>
+
+template<class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class SolutionPool {
+	Population<P, pSize, F, fSize, V, vSize> *storage;
+	Solution<P, pSize, F, fSize, V, vSize> **solutions;
+	int *freeList;	// Stack of the indices available.
+	int nFree;
+	int capacity;
+
+	int indexOf(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		for(int i=0; i < capacity; i++) {
+			if(solutions[i] == solution) return i;
+		}
+		return -1;
+	}
+
+public:
+	/**
+	 * @brief Constructor to create the pool.
+	 * @param capacity The maximum number of Solutions handed out at the same time.
+	 * @param nDimensions The number of dimensions of every Solution.
+	 */
+	SolutionPool(int capacity, int nDimensions) {
+		if(capacity <= 0) throw std::invalid_argument("The pool capacity must be greater than zero.");
+		this->capacity = capacity;
+		storage = new Population<P, pSize, F, fSize, V, vSize>(capacity, nDimensions);
+		solutions = storage->getSolutions();
+		freeList = new int[capacity];
+		// The first Solutions are handed out first.
+		for(int i=0; i < capacity; i++) freeList[i] = capacity - 1 - i;
+		nFree = capacity;
+	}
+	~SolutionPool() {
+		delete[] freeList;
+		delete storage;
+	}
+
+	/**
+	 * @brief Take a Solution from the pool.
+	 *
+	 * The contents of the Solution are undefined (they must be overridden by the caller).
+	 *
+	 * @return The Solution, which belongs to the caller until {@link release()}.
+	 * @throws bad_alloc if all Solutions are in use.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* acquire() {
+		if(nFree == 0) throw std::bad_alloc();
+		return solutions[freeList[--nFree]];
+	}
+
+	/**
+	 * @brief Take a Solution from the pool, initialized as a copy of the Solution received.
+	 * @param solution The source Solution instance.
+	 */
+	Solution<P, pSize, F, fSize, V, vSize>* acquire(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		Solution<P, pSize, F, fSize, V, vSize> *copy = acquire();
+		*copy = solution;
+		return copy;
+	}
+
+	/**
+	 * @brief Give a Solution back to the pool.
+	 * @param solution A Solution obtained from this pool.
+	 * @throws invalid_argument if the Solution does not belong to this pool.
+	 */
+	void release(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		int i = indexOf(solution);
+		if(i < 0) throw std::invalid_argument("The solution does not belong to the pool.");
+		freeList[nFree++] = i;
+	}
+
+	/**
+	 * @brief Check if the Solution has been obtained from this pool.
+	 */
+	bool owns(Solution<P, pSize, F, fSize, V, vSize> *solution) {
+		return indexOf(solution) >= 0;
+	}
+
+	int getCapacity() {
+		return capacity;
+	}
+
+	/**
+	 * @brief Get the number of Solutions available.
+	 */
+	int getNFree() {
+		return nFree;
+	}
+};
+
+#endif /* SOLUTIONPOOL_H_ */
@@ -0,0 +1,94 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file StaticTHBuilder.h
+ * @class StaticTHBuilder
+ * @author Peter Frank Perroni
+ * @brief Treasure Hunt Framework Builder composed at compile time with the fitness policy type.
+ * @details On the regular THBuilder, every fitness evaluation and comparison performed by the
+ *          search algorithms is a virtual call to the FitnessPolicy. For cheap fitness functions,
+ *          these calls can cost as much as the function itself.
+ *
+ *          This builder takes the concrete fitness policy type (FP) as a template parameter, and
+ *          instantiates the search algorithms (including the default local search) with it, so that
+ *          they call FP directly. When FP is declared final, the compiler binds these calls at
+ *          compile time and can inline them into the search loops.
+ *
+ *          The TH instances built are exactly the same as the ones of THBuilder (the remaining
+ *          policies keep their virtual interfaces, since they run once per iteration),
+ *          so the regular search algorithms can still be added through the regular methods.
+ *
+ *          Example:
+ *          <pre>
+ *          StaticTHBuilder<RosenbrockFitnessPolicy> *builder = new StaticTHBuilder<RosenbrockFitnessPolicy>();
+ *          builder->setFitnessPolicy(new RosenbrockFitnessPolicy())
+ *                 ->addSearchAlgorithm<PSO>(0.9, 0.7, 0.7, 12)
+ *                 ->addSearchAlgorithm<HillClimbing>(0.5, 0.1, 12);
+ *          builder->setMaxIterations(100)->...;
+ *          </pre>
+ */
+
+#ifndef STATICTHBUILDER_H_
+#define STATICTHBUILDER_H_
+
+#include "THBuilder.h"
+#include "HillClimbing.h"
+
+template <class FP, class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class StaticTHBuilder : public THBuilder<P, pSize, F, fSize, V, vSize> {
+public:
+	StaticTHBuilder() : THBuilder<P, pSize, F, fSize, V, vSize>() {
+		THBuilder<P, pSize, F, fSize, V, vSize>::setLocalSearchAlgorithm(
+				new HillClimbing<P, pSize, F, fSize, V, vSize, FP>(0.05, 1e-3, 1));
+	}
+
+	using THBuilder<P, pSize, F, fSize, V, vSize>::addSearchAlgorithm;
+
+	/**
+	 * @brief Set the FitnessPolicy.
+	 *
+	 * If a FitnessPolicy has already been set, it will be deleted
+	 * before setting the new instance.
+	 *
+	 * @param fitnessPolicy The fitness policy to be used.
+	 * @return A pointer to this builder.
+	 */
+	StaticTHBuilder<FP, P, pSize, F, fSize, V, vSize>* setFitnessPolicy(FP *fitnessPolicy) {
+		THBuilder<P, pSize, F, fSize, V, vSize>::setFitnessPolicy(fitnessPolicy);
+		return this;
+	}
+
+	/**
+	 * @brief Add a search algorithm instantiated for the fitness policy type.
+	 *
+	 * The search algorithm S is created as S<P, pSize, F, fSize, V, vSize, FP>(args...),
+	 * with a weight of 1 for the scoring metrics.
+	 *
+	 * @param args The arguments of the search algorithm's constructor.
+	 * @return A pointer to this builder.
+	 */
+	template <template <class, int, class, int, class, int, class> class S, class... Args>
+	StaticTHBuilder<FP, P, pSize, F, fSize, V, vSize>* addSearchAlgorithm(Args... args) {
+		THBuilder<P, pSize, F, fSize, V, vSize>::addSearchAlgorithm(new S<P, pSize, F, fSize, V, vSize, FP>(args...));
+		return this;
+	}
+};
+
+#endif /* STATICTHBUILDER_H_ */
@@ -61,6 +61,17 @@ public:
 	 */
 	virtual long long getNEvals() = 0;
 
+	/**
+	 * @brief Get the number of heap allocations performed during the steady-state iterations
+	 *        (i.e. every iteration after the first one).
+	 *
+	 * Only available when TH is compiled with TH_COUNT_ALLOCATIONS, and the counting
+	 * operators are defined in the program (see AllocationCounter.h).
+	 *
+	 * @return The number of allocations, or -1 if not available.
+	 */
+	virtual long long getSteadyStateAllocations() { return -1; }
+
 	/**
 	 * @brief Get this TH instance's unique identifier.
 	 * @return This TH instance's unique identifier.
@@ -45,7 +45,10 @@
 #include "RandomBestListSelectionPolicy.h"
 
 #include "THTree.h"
+#include "KAryTHTree.h"
+#include "LocalityTHTree.h"
 #include "Solution.h"
+#include "Population.h"
 #include "BestList.h"
 #include "BestListSelectionPolicy.h"
 #include "BestListUpdatePolicy.h"
@@ -65,7 +68,11 @@
 #include "ConvergenceControlPolicy.h"
 #include "RelocationStrategyPolicy.h"
 #include "THUtil.h"
+#include "ThreadPool.h"
+#include "CommEngine.h"
 #include "MpiTypeTraits.h"
+#include "SolutionPool.h"
+#include "AllocationCounter.h"
 
 #include <stddef.h>
 #include <stdexcept>
@@ -108,6 +115,7 @@ class THBuilder {
 	Solution<P, pSize, F, fSize, V, vSize> *bias;
 	Solution<P, pSize, F, fSize, V, vSize> **startupSolutions;
 	TH<P, pSize, F, fSize, V, vSize> *th;
+	ThreadPool *threadPool;
 
 	bool built;
 	int ID;
@@ -119,6 +127,11 @@ class THBuilder {
 	long long nEvals;
 	long double elapsedSeconds;
 	int nStartupSolutions;
+	int nThreads;
+	int exchangeCodec;
+	bool commThread;
+	bool sharedMemoryTransport;
+	bool immigration;
 
 	struct sigaction newSignalAction, oldSignalAction;
 
@@ -174,6 +187,7 @@ public:
 		startupSolutions = NULL;
 
 		th = NULL;
+		threadPool = NULL;
 		thTree = NULL;
 		regionSelectionPolicy = NULL;
 		fitnessPolicy = NULL;
@@ -196,13 +210,19 @@ public:
 		elapsedSeconds = 0;
 		bestListSize = 1;
 		nStartupSolutions = 0;
+		nThreads = 1;
+		exchangeCodec = EXCHANGE_CODEC_RAW;
+		commThread = false;
+		sharedMemoryTransport = false;
+		immigration = false;
 
 		newSignalAction.sa_flags = SA_SIGINFO;
 		newSignalAction.sa_sigaction = signalActionHandler;
 		sigaction(SIGABRT, &newSignalAction, &oldSignalAction);
 	}
-	~THBuilder(){
+	virtual ~THBuilder(){
 		if(fitnessPolicy != NULL) delete fitnessPolicy;
+		if(threadPool != NULL) delete threadPool;
 		if(regionSelectionPolicy != NULL) delete regionSelectionPolicy;
 		if(relocationStrategyData != NULL) delete relocationStrategyData;
 		if(convergenceControl != NULL) delete convergenceControl;
@@ -248,12 +268,19 @@ public:
 
 	/**
 	 * @brief Start the MPI environment.
+	 *
+	 * MPI is initialized with MPI_THREAD_SERIALIZED support, so that the worker threads
+	 * (see {@link setNThreads()}) can run alongside the thread that performs the MPI calls,
+	 * and the communication thread (see {@link setCommThread()}) can take over the MPI calls
+	 * during the search phase.
+	 *
 	 * @param argc The operating system argc.
 	 * @param argv The operating system argv.
 	 * @return A pointer to this builder.
 	 */
 	THBuilder<P, pSize, F, fSize, V, vSize>* setMpiComm(int argc, char *argv[]){
-		MPI_Init(&argc, &argv);
+		int provided;
+		MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
 		setMpiComm(MPI_COMM_WORLD);
 		return this;
 	}
@@ -305,6 +332,26 @@ public:
 		return this;
 	}
 
+	/**
+	 * @brief Set a THTree topology that follows the physical location of the TH instances.
+	 *
+	 * The TH instances in the same host form a whole subtree, so that only the upper levels
+	 * communicate across the hosts (see {@link LocalityTHTree}).
+	 * This is a collective operation, that requires {@link setMpiComm()} to be called before.
+	 *
+	 * The children hosts take the child positions K to 2K-1, so the region selection policy
+	 * must be able to address 2K positions. If no region selection policy is set, TH uses
+	 * GroupRegionSelectionPolicy(2, K) (or (1, 2) for K=1); otherwise, TH throws
+	 * invalid_argument when it starts if the policy cannot address all the positions used.
+	 *
+	 * @param K The number of children of every node inside the hosts, and of every host.
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setLocalityTHTree(int K){
+		if(cartGrid == NULL) throw std::invalid_argument("The MPI communication must be set before the locality tree.");
+		return setTHTree(new LocalityTHTree(cartGrid, K));
+	}
+
 	/**
 	 * @brief Get the BestListSelectionPolicy configured.
 	 *
@@ -810,6 +857,123 @@ public:
 		return this;
 	}
 
+	int getNThreads() {
+		return nThreads;
+	}
+
+	/**
+	 * @brief Set the number of threads used by this TH instance to evaluate its population.
+	 *
+	 * When more than one thread is set, the population batches (search algorithm's steps,
+	 * population reset and relocation) are evaluated in parallel by an internal thread pool,
+	 * so the {@link FitnessPolicy::apply()} must be thread-safe. The relocation itself is also
+	 * split among the threads, every thread drawing from its own random stream
+	 * (see {@link ThreadPool::getSeed()}), so the same number of threads reproduces the same run.
+	 * All MPI communication is still performed by the main thread only.
+	 *
+	 * @param nThreads The number of threads (default is 1, i.e. sequential evaluation).
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setNThreads(int nThreads) {
+		if(nThreads < 1) throw std::invalid_argument("The number of threads must be greater than zero.");
+		this->nThreads = nThreads;
+		return this;
+	}
+
+	int getExchangeCodec() {
+		return exchangeCodec;
+	}
+
+	/**
+	 * @brief Set the codec used to exchange solutions between this TH instance and its parent and children.
+	 *
+	 * EXCHANGE_CODEC_FP32 and EXCHANGE_CODEC_DELTA reduce the interconnect traffic for large
+	 * numbers of dimensions, and do not resend a solution identical to the last one sent to the same peer.
+	 * The final result sent to the parent is always lossless.
+	 * All TH instances must use the same codec, and the encoded codecs require all nodes to share
+	 * the same data representation.
+	 *
+	 * @param exchangeCodec EXCHANGE_CODEC_RAW (default), EXCHANGE_CODEC_FP32 or EXCHANGE_CODEC_DELTA (see macros.h).
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setExchangeCodec(int exchangeCodec) {
+		if(exchangeCodec != EXCHANGE_CODEC_RAW && exchangeCodec != EXCHANGE_CODEC_FP32 && exchangeCodec != EXCHANGE_CODEC_DELTA) {
+			throw std::invalid_argument("Invalid exchange codec.");
+		}
+		this->exchangeCodec = exchangeCodec;
+		return this;
+	}
+
+	bool isCommThread() {
+		return commThread;
+	}
+
+	/**
+	 * @brief Enable the communication thread.
+	 *
+	 * During the search phase, a dedicated thread performs all the exchanges with the parent
+	 * and children, so that they progress while the search is running long iterations.
+	 * The solutions are handed between the search and the communication threads through
+	 * lock-free mailboxes, and only the last solution of each peer is kept.
+	 * Requires MPI_THREAD_SERIALIZED support (see {@link setMpiComm(int, char**)}).
+	 *
+	 * @param commThread True to enable the communication thread (disabled by default).
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setCommThread(bool commThread) {
+		this->commThread = commThread;
+		return this;
+	}
+
+	bool isSharedMemoryTransport() {
+		return sharedMemoryTransport;
+	}
+
+	/**
+	 * @brief Enable the shared-memory transport between the parent and children in the same host.
+	 *
+	 * Every TH instance publishes the solutions sent to its same-host peers into shared-memory slots
+	 * (MPI_Win_allocate_shared), which the peers read in place, instead of exchanging MPI messages.
+	 * These solutions are always exchanged in full, regardless of the exchange codec.
+	 * All TH instances must use the same setting, since the TH construction and destruction become
+	 * collective operations over the TH instances of the same host.
+	 * It pairs well with {@link setLocalityTHTree()}, which keeps most of the tree inside the hosts.
+	 *
+	 * @param sharedMemoryTransport True to enable the shared-memory transport (disabled by default).
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setSharedMemoryTransport(bool sharedMemoryTransport) {
+		this->sharedMemoryTransport = sharedMemoryTransport;
+		return this;
+	}
+
+	bool isImmigration() {
+		return immigration;
+	}
+
+	/**
+	 * @brief Enable the mid-run immigration.
+	 *
+	 * The solutions received from the parent and children are injected into the running
+	 * search algorithm between two consecutive steps (see {@link Search::injectImmigrant()}),
+	 * instead of waiting for the current TH iteration to complete.
+	 *
+	 * @param immigration True to enable the mid-run immigration (disabled by default).
+	 * @return A pointer to this builder.
+	 */
+	THBuilder<P, pSize, F, fSize, V, vSize>* setImmigration(bool immigration) {
+		this->immigration = immigration;
+		return this;
+	}
+
+	/**
+	 * @brief Get the thread pool shared by this TH instance.
+	 * @return The thread pool, or NULL if a single thread is configured.
+	 */
+	ThreadPool* getThreadPool() {
+		return threadPool;
+	}
+
 	int getBestListSize() {
 		return bestListSize;
 	}
@@ -830,11 +994,12 @@ public:
 	class SearchGroup {
 		THBuilder<P, pSize, F, fSize, V, vSize> *config;
 		THTree *thTree;
-		t_node * currNode;
+		bool hasParent;	// False for the root of the tree.
 		Region<P> *region;
 		vector<SearchScore<P, pSize, F, fSize, V, vSize>*> *searchAlgorithms;
 		Search<P, pSize, F, fSize, V, vSize> *searchAlgorithmLastExecuted;
 		ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> *convergenceControlPolicy;
+		Population<P, pSize, F, fSize, V, vSize> *populationStore;
 		Solution<P, pSize, F, fSize, V, vSize> **population;
 		FitnessPolicy<P, pSize, F, fSize, V, vSize> *fitnessPolicy;
 
@@ -862,8 +1027,8 @@ public:
 
 			ID = config->getId();
 			thTree = config->getTHTree();
-			currNode = thTree->getNode(ID);
-			L = currNode->getLevel();
+			L = thTree->getLevel(ID);
+			hasParent = thTree->getParentID(ID) != -1;
 			n = config->getSearchSpace()->getNDimensions();
 
 			searchAlgorithms = config->getSearchAlgorithms();
@@ -879,14 +1044,13 @@ public:
 				if(search != NULL){
 					search->setFitnessPolicy(fitnessPolicy);
 					search->setSearchSpace(config->getSearchSpace());
+					search->reserve(maxPopulationSize);
 				}
 			}
 
-			// Create TH population.
-			population = new Solution<P, pSize, F, fSize, V, vSize>*[maxPopulationSize];
-			for(int i=0; i < maxPopulationSize; i++){
-				population[i] = new Solution<P, pSize, F, fSize, V, vSize>(n);
-			}
+			// Create TH population (contiguous storage, individuals are views).
+			populationStore = new Population<P, pSize, F, fSize, V, vSize>(maxPopulationSize, n);
+			population = populationStore->getSolutions();
 			iterationBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
 
 			searchAlgorithmLastExecuted = NULL;
@@ -894,7 +1058,7 @@ public:
 
 			// Only the Root level can set the bias.
 			bias = NULL;
-			if(currNode->isRoot()) {
+			if(!hasParent) {
 				bias = config->getBias();
 				if(bias != NULL) {
 					fitnessPolicy->apply(bias);
@@ -906,10 +1070,7 @@ public:
 			}
 		}
 		~SearchGroup(){
-			for(int i=0; i < maxPopulationSize; i++){
-				delete population[i];
-			}
-			delete population;
+			delete populationStore;
 			delete iterationBest;
 		}
 
@@ -924,7 +1085,7 @@ public:
 			improvedGeneralBest = false;
 			Search<P, pSize, F, fSize, V, vSize> *selectedSearchAlgorithm =
 					config->getSearchAlgorithmSelectionPolicy()->apply(ID, thTree, searchAlgorithms);
-			selectedSearchAlgorithm->setPopulation(population, getPopulationSize());
+			selectedSearchAlgorithm->setPopulation(populationStore);
 			convergenceControlPolicy->run(selectedSearchAlgorithm);
 			//DEBUG_SOLUTION_DOUBLE(ID, "Population after optimization", population, getPopulationSize(), n);
 			config->incrementEvals(selectedSearchAlgorithm->getCurrentNEvals());
@@ -953,6 +1114,10 @@ public:
 			return population;
 		}
 
+		Population<P, pSize, F, fSize, V, vSize>* getPopulationStore() {
+			return populationStore;
+		}
+
 		int getPopulationSize() {
 			return maxPopulationSize;
 		}
@@ -979,13 +1144,13 @@ public:
 			int nStartupSolutions = config->getNStartupSolutions();
 			for(int i=0; i < maxPopulationSize; i++){
 				// For root node, reposition the population members to the startup positions.
-				if(currNode->isRoot() && i < nStartupSolutions) {
+				if(!hasParent && i < nStartupSolutions) {
 					*population[i] = startupSolutions[i];
 				}
 				// If a bias has been provided.
 				else if(bias != NULL) {
 					// For root node, only 1 individual will be repositioned to bias position.
-					if(currNode->isRoot() && !hasUsedBias) {
+					if(!hasParent && !hasUsedBias) {
 						hasUsedBias = true;
 						*population[i] = bias;
 					}
@@ -997,8 +1162,9 @@ public:
 				}
 				// Reposition the population members inside the "anchor" sub-region.
 				else population[i]->reset(region);
-
-				fitnessPolicy->apply(population[i]); // Calculate the respective fitness.
+			}
+			fitnessPolicy->applyBatch(population, maxPopulationSize); // Calculate the respective fitness.
+			for(int i=0; i < maxPopulationSize; i++){
 				if(i == 0 || fitnessPolicy->firstIsBetter(population[i], iterationBest)){
 					*iterationBest = population[i];
 				}
@@ -1039,27 +1205,29 @@ public:
 	/**
 	 * @brief Actual implementation of Treasure Hunt.
 	 */
-	class THImpl : public TH<P, pSize, F, fSize, V, vSize> {
+	class THImpl : public TH<P, pSize, F, fSize, V, vSize>, public ImmigrationSource<P, pSize, F, fSize, V, vSize> {
 		THBuilder *config;
 		THTree *thTree;
-		t_node * currNode;
+		bool hasParent, hasChildren;	// Position of this TH instance in the tree.
 		Region<P> *subRegion;
 		SearchGroup *searchGroup;
 		Search<P, pSize, F, fSize, V, vSize> *localSearchAlgorithm;
 		ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> *convergenceControlPolicy;
 		BestList<P, pSize, F, fSize, V, vSize> *bestList, *bestListCopy;
 		Solution<P, pSize, F, fSize, V, vSize> **population, *generalBest, *generalBestCopy, *parentBest, *bias;
+		Solution<P, pSize, F, fSize, V, vSize> *selectedFromBestList;
+		SolutionPool<P, pSize, F, fSize, V, vSize> *solutionPool;	// Backs the best-list and the solutions used by run().
+		long long steadyStateAllocations;
 		FitnessPolicy<P, pSize, F, fSize, V, vSize> *fitnessPolicy;
 		IterationData<P, pSize, F, fSize, V, vSize> *iterationData;
 		RelocationStrategyData<P, pSize, F, fSize, V, vSize> *relocationStrategyData;
 
 		bool executed;
 		struct timeval startTime, currTime;
-		int ID, L, parentTH, *childrenTHs, nChildren, *childrenStatuses, *commChildrenStatuses, populationSize, n;
+		int ID, L, parentTH, *childrenTHs, nChildren, populationSize, n;
 		MPI_Comm cartGrid;
-		MPI_Request *reqReadHHbFromParent, *reqSendHbToParent, *reqReadHhFromChildren, *reqSendToChildren, reqReadFinalize;
-		P *commSendHbToParent, **commReadHhFromChildren, **Hh, **commSendToChildren, *commReadHHbFromParent, *HHb;
-		F *commSendHbFitToParent, *commReadHHbFitFromParent, *HHbFit, *commReadHhFitFromChildren, *commSendFitToChildren, *HhFit;
+		CommEngine<P, pSize, F, fSize, V, vSize> *commEngine;
+		bool immigrantsPolled;
 
 		long double calcElapsedSeconds(struct timeval startTime, struct timeval endTime){
 			return (endTime.tv_sec - startTime.tv_sec) +
@@ -1085,15 +1253,37 @@ public:
 				throw std::invalid_argument("At least one budget limit must be provided: [iterations, evaluations, seconds].");
 			}
 
+			// The locality tree places the children hosts after the K children inside the host.
+			LocalityTHTree *localityTree = dynamic_cast<LocalityTHTree*>(config->getTHTree());
+			if(localityTree != NULL) {
+				if(config->regionSelectionPolicy == NULL) {
+					int K = localityTree->getFanout();
+					config->regionSelectionPolicy = (K > 1) ? new GroupRegionSelectionPolicy<P, pSize, F, fSize, V, vSize>(2, K)
+															: new GroupRegionSelectionPolicy<P, pSize, F, fSize, V, vSize>(1, 2);
+				}
+				long long nPositions = config->getRegionSelectionPolicy()->getNChildPositions();
+				if(nPositions >= 0 && nPositions <= localityTree->getMaxChildPosition()) {
+					throw std::invalid_argument("The region selection policy cannot address all the child positions of the locality tree (up to 2*K).");
+				}
+			}
+
 			this->config = config;
 			executed = false;
 
+			// Intra-rank parallelism.
+			if(config->getNThreads() > 1) {
+				config->threadPool = new ThreadPool(config->getNThreads(), THUtil::getRandomSeed());
+				config->getFitnessPolicy()->setThreadPool(config->threadPool);
+				config->getRelocationStrategyPolicy()->setThreadPool(config->threadPool);
+			}
+
 			// Tree configuration.
 			thTree = config->getTHTree();
 			thTree->lock(); // Avoid updates in the tree after TH has begun.
 			ID = config->getId();	// ID in the tree.
-			currNode = thTree->getNode(ID);
-			L = currNode->getLevel();
+			L = thTree->getLevel(ID);
+			hasParent = thTree->getParentID(ID) != -1;
+			hasChildren = thTree->getNChildren(ID) > 0;
 			n = config->getSearchSpace()->getNDimensions();
 
 			DEBUG_TEXT("TH[%i] located at L[%i].\n", ID, L);
@@ -1117,68 +1307,30 @@ public:
 			DEBUG_TEXT_IF(L != thTree->getRootLevel(), "TH[%i]'s parent is TH[%i].\n", ID, parentTH);
 			DEBUG2FILE_TEXT_IF(ID, L != thTree->getRootLevel(), "TH[%i]'s parent is TH[%i].\n", ID, parentTH);
 
-			// Communication buffers and channels.
+			// Communication channels.
 			nChildren = children.size();
-			if(currNode->hasChildren()){
+			if(hasChildren){
 				childrenTHs = new int[nChildren];
-				reqReadHhFromChildren = new MPI_Request[nChildren * 3];
-				reqSendToChildren = new MPI_Request[nChildren * 2];
-				commReadHhFromChildren = new P*[nChildren];
-				commSendToChildren = new P*[nChildren];
-				Hh = new P*[nChildren];
-				HhFit = new F[nChildren * fSize];
 				for(int i=0; i < nChildren; i++){
 					childrenTHs[i] = children.at(i);
-					commReadHhFromChildren[i] = new P[n * pSize];
-					commSendToChildren[i] = new P[n * pSize];
-					Hh[i] = new P[n * pSize];
-					reqReadHhFromChildren[i*3] = reqReadHhFromChildren[i*3 + 1] = reqReadHhFromChildren[i*3 + 2] = NULL;
-					reqSendToChildren[i*2] = reqSendToChildren[i*2 + 1] = NULL;
-					reqReadFinalize = NULL;
 				}
-				commReadHhFitFromChildren = new F[nChildren * fSize];
-				commSendFitToChildren = new F[nChildren * fSize];
-				commChildrenStatuses = new int[nChildren];
-				childrenStatuses = new int[nChildren];
-				memset(commChildrenStatuses, 0, nChildren*sizeof(int)); // Initialize Children status with zero.
-				memset(childrenStatuses, 0, nChildren*sizeof(int));
-			}
-			else {
-				reqReadHhFromChildren = reqSendToChildren = NULL;
-				commReadHhFromChildren = commSendToChildren = Hh = NULL;
-				HhFit = commReadHhFitFromChildren = commSendFitToChildren = NULL;
-				childrenTHs = childrenStatuses = commChildrenStatuses  = NULL;
 			}
+			else childrenTHs = NULL;
 
 			DEBUG_TEXT("TH[%i] contains %i children%s\n", ID, nChildren, (nChildren > 0 ? ": " : "."));
 			DEBUG2FILE_TEXT(ID, "TH[%i] contains %i children%s\n", ID, nChildren, (nChildren > 0 ? ": " : "."));
 			DEBUG_VECTOR_INT_IF(nChildren > 0, ID, "Child IDs", childrenTHs, nChildren);
 
-			if(currNode->hasParent()){
-				HHb = new P[n * pSize];
-				commSendHbToParent = new P[n * pSize];
-				commReadHHbFromParent = new P[n * pSize];
-				reqReadHHbFromParent = new MPI_Request[2];
-				reqSendHbToParent = new MPI_Request[3];
-				commSendHbFitToParent = new F[fSize];
-				commReadHHbFitFromParent = new F[fSize];
-				HHbFit = new F[fSize];
-				reqReadHHbFromParent[0] = reqReadHHbFromParent[1] = NULL;
-				reqSendHbToParent[0] = reqSendHbToParent[1] = reqSendHbToParent[2] = NULL;
-			}
-			else {
-				HHb = commSendHbToParent = commReadHHbFromParent = NULL;
-				reqReadHHbFromParent = reqSendHbToParent = NULL;
-				commSendHbFitToParent = commReadHHbFitFromParent = HHbFit = NULL;
-			}
-
 			bestListCopy = NULL;
 			generalBestCopy = NULL;
 
 			// Best solutions.
-			bestList = new BestList<P, pSize, F, fSize, V, vSize>(config->getBestListSize(), n);
+			solutionPool = new SolutionPool<P, pSize, F, fSize, V, vSize>(config->getBestListSize() + 1, n);
+			bestList = new BestList<P, pSize, F, fSize, V, vSize>(config->getBestListSize(), n, solutionPool);
+			selectedFromBestList = solutionPool->acquire();
+			steadyStateAllocations = -1;
 			generalBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
-			parentBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
+			parentBest = generalBest;
 			fitnessPolicy = config->getFitnessPolicy();
 			fitnessPolicy->setWorstFitness(generalBest); // Allow the convergence to occur.
 
@@ -1190,13 +1342,17 @@ public:
 			population = searchGroup->getPopulation(); // Obtain the population created by the search group.
 			populationSize = searchGroup->getPopulationSize();
 			convergenceControlPolicy = config->getConvergenceControlPolicy();
+			immigrantsPolled = false;
+			if(config->isImmigration()) convergenceControlPolicy->setImmigrationSource(this);
 			localSearchAlgorithm = config->getLocalSearchAlgorithm();
 			localSearchAlgorithm->setFitnessPolicy(fitnessPolicy);
 			localSearchAlgorithm->setSearchSpace(config->getSearchSpace());
-			bias = (currNode->isRoot() ? config->getBias() : NULL); // Only root node has Bias.
+			localSearchAlgorithm->reserve(1);
+			config->getRelocationStrategyPolicy()->reserve(populationSize, n);
+			bias = (!hasParent ? config->getBias() : NULL); // Only root node has Bias.
 
 			// Configuration for relocation strategy.
-			iterationData = new IterationData<P, pSize, F, fSize, V, vSize>(population, populationSize,
+			iterationData = new IterationData<P, pSize, F, fSize, V, vSize>(searchGroup->getPopulationStore(),
 					config->getMaxTimeSeconds(), config->getMaxNumberEvaluations(), config->getMaxIterations());
 			relocationStrategyData = config->getRelocationStrategyData();
 			relocationStrategyData->setIterationData(iterationData);
@@ -1206,12 +1362,21 @@ public:
 			// -----------
 
 			cartGrid = config->getCartGrid();
+			if(config->isCommThread()) {
+				int provided;
+				MPI_Query_thread(&provided);
+				if(provided < MPI_THREAD_SERIALIZED) {
+					throw std::invalid_argument("The communication thread requires MPI_THREAD_SERIALIZED support.");
+				}
+			}
+			commEngine = new CommEngine<P, pSize, F, fSize, V, vSize>(cartGrid, ID, parentTH, childrenTHs, nChildren, n,
+					config->getExchangeCodec(), config->isSharedMemoryTransport());
 
 			// Start all searches at same point in time, to keep a good cooperation.
 			if(thTree->getCurrentSize() > 1) {
 				int signal = 1;
 				// The leaves unlock the search.
-				if(currNode->isLeaf()){
+				if(!hasChildren){
 					MPI_Send(&signal, 1, MPI_INT, parentTH, MSG_STARTUP, cartGrid);
 					DEBUG_TEXT("TH[%i] sent startup signal to parent TH[%i].\n", ID, parentTH);
 					DEBUG2FILE_TEXT(ID, "TH[%i] sent startup signal to parent TH[%i].\n", ID, parentTH);
@@ -1219,7 +1384,7 @@ public:
 				else{
 					// Parent nodes read startup signal from children.
 					for(int i=0; i < nChildren; i++){
-						if(MPI_Recv(&childrenStatuses[i], 1, MPI_INT, childrenTHs[i], MSG_STARTUP, cartGrid, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+						if(MPI_Recv(&signal, 1, MPI_INT, childrenTHs[i], MSG_STARTUP, cartGrid, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
 							DEBUG_TEXT("TH[%i] error receiving startup signal from child TH[%i].\n", ID, childrenTHs[i]);
 							DEBUG2FILE_TEXT(ID, "TH[%i] error receiving startup signal from child TH[%i].\n", ID, childrenTHs[i]);
 							exit(1);
@@ -1228,7 +1393,7 @@ public:
 						DEBUG2FILE_TEXT(ID, "TH[%i] received startup signal from child TH[%i].\n", ID, childrenTHs[i])
 					}
 					// Non-leaf child nodes send startup signal to parent.
-					if(currNode->hasParent()){
+					if(hasParent){
 						MPI_Send(&signal, 1, MPI_INT, parentTH, MSG_STARTUP, cartGrid);
 						DEBUG_TEXT("TH[%i] sent startup signal to parent TH[%i].\n", ID, parentTH)
 						DEBUG2FILE_TEXT(ID, "TH[%i] sent startup signal to parent TH[%i].\n", ID, parentTH)
@@ -1236,51 +1401,48 @@ public:
 				}
 			}
 
+			// From now on, every channel always has a receive posted.
+			commEngine->start();
+
 			DEBUG_TEXT("Construction of TH[%i] completed.\n", ID);
 			DEBUG2FILE_TEXT(ID, "Construction of TH[%i] completed.\n", ID);
 		}
 		~THImpl(){
+			if(config->isImmigration()) convergenceControlPolicy->setImmigrationSource(NULL);
+			delete commEngine;
 			delete bestList;
+			delete solutionPool;
 			delete generalBest;
-			delete parentBest;
 			delete iterationData;
 			delete config;
 
-			if(currNode->hasChildren()) {
-				delete commReadHhFitFromChildren;
-				delete commSendFitToChildren;
-				delete reqReadHhFromChildren;
-				delete reqSendToChildren;
-				delete HhFit;
-				delete commChildrenStatuses;
-				delete childrenStatuses;
-				for(int i=0; i < nChildren; i++){
-					delete commReadHhFromChildren[i];
-					delete commSendToChildren[i];
-					delete Hh[i];
-				}
-				delete commReadHhFromChildren;
-				delete commSendToChildren;
-				delete Hh;
-				delete childrenTHs;
-			}
-
-			if(currNode->hasParent()){
-				delete HHb;
-				delete commSendHbToParent;
-				delete commReadHHbFromParent;
-				delete reqReadHHbFromParent;
-				delete reqSendHbToParent;
-				delete commSendHbFitToParent;
-				delete commReadHHbFitFromParent;
-				delete HHbFit;
-			}
+			if(childrenTHs != NULL) delete[] childrenTHs;
 
 			if(subRegion != NULL) delete subRegion;
 
 			delete searchGroup;
 		}
 
+		/**
+		 * @brief Get the next Solution received from the parent or children, to be injected into the running search.
+		 *
+		 * The communication engine is polled once per sequence of calls (which ends when NULL is returned).
+		 * The Solutions remain available to the processing done at the end of the TH iteration.
+		 */
+		Solution<P, pSize, F, fSize, V, vSize>* nextImmigrant() {
+			if(!immigrantsPolled) {
+				commEngine->poll();
+				immigrantsPolled = true;
+			}
+			Solution<P, pSize, F, fSize, V, vSize> *immigrant;
+			for(int i=0; i < nChildren; i++){
+				if((immigrant = commEngine->peekFromChild(i)) != NULL) return immigrant;
+			}
+			if(hasParent && (immigrant = commEngine->peekFromParent()) != NULL) return immigrant;
+			immigrantsPolled = false;
+			return NULL;
+		}
+
 		/**
 		 * @brief Starts the Treasure Hunt mechanisms.
 		 */
@@ -1289,47 +1451,42 @@ public:
 			DEBUG2FILE_TEXT(ID, "Running TH[%i]...\n", ID);
 
 			gettimeofday(&startTime, NULL);
-			int commFlag;
 			int commStatus = 1;  // Tell to the parent this child TH instance has begun.
-			Solution<P, pSize, F, fSize, V, vSize> *childBest = new Solution<P, pSize, F, fSize, V, vSize>(n);
-			Solution<P, pSize, F, fSize, V, vSize> *selectedFromBestList =
-						new Solution<P, pSize, F, fSize, V, vSize>(config->getBestListSelectionPolicy()->apply(bestList, fitnessPolicy));
+			Solution<P, pSize, F, fSize, V, vSize> *childBest = NULL;
+			*selectedFromBestList = config->getBestListSelectionPolicy()->apply(bestList, fitnessPolicy);
 			int i, popSeq, t = 1;
 			int T = config->getMaxIterations();
 			int maxNumberEvaluations = config->getMaxNumberEvaluations();
 			int maxTimeSeconds = config->getMaxTimeSeconds();
-			bool hasChildrenImproved = false, hasReadValue, runNextIteration;
+			bool hasChildrenImproved = false, runNextIteration;
+			if(maxTimeSeconds > 0) {
+				// Enforce the time limit also inside the optimizations.
+				std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(maxTimeSeconds);
+				convergenceControlPolicy->setDeadline(deadline);
+				localSearchAlgorithm->setDeadline(deadline);
+			}
 
+#ifdef TH_COUNT_ALLOCATIONS
+			long long allocations;
+			steadyStateAllocations = 0;
+#endif
+			if(config->isCommThread()) commEngine->startThread();
 			do{
+#ifdef TH_COUNT_ALLOCATIONS
+				allocations = THAllocationCounter::count().load();
+#endif
 				searchGroup->run();
 
 				// -------------------------------
 				// If this TH instance has parent.
 				// -------------------------------
 				// Send the global best to the parent.
-				if(currNode->hasParent()){
+				if(hasParent){
 					if((searchGroup->hasImprovedGeneralBest() || hasChildrenImproved)) {
-						if(reqSendHbToParent[0] != NULL) {
-							// If previous send has already completed.
-							DEBUG_TEXT("TH[%i] checking if parent TH[%i] received the best value sent.\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] checking if parent TH[%i] received the best value sent.\n", ID, parentTH);
-							if(MPI_Testall(3, reqSendHbToParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-								DEBUG_TEXT("TH[%i] error sending best value to parent TH[%i].\n", ID, parentTH);
-								DEBUG2FILE_TEXT(ID, "TH[%i] error sending best value to parent TH[%i].\n", ID, parentTH);
-								exit(1);
-							}
-						}
-						else commFlag = 2;
-						if(commFlag == 2 || (reqSendHbToParent[0] == MPI_REQUEST_NULL && commFlag)){
-							generalBest->getPositions(commSendHbToParent); // Gb positions.
-							generalBest->getFitness(commSendHbFitToParent); // Fitness.
-							DEBUG_TEXT("TH[%i] trying to send best value to parent TH[%i].\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to parent TH[%i].\n", ID, parentTH);
-							MPI_Isend(commSendHbToParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[0]);
-							MPI_Isend(commSendHbFitToParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[1]);
-							MPI_Isend(&commStatus, 1, MPI_INT, parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[2]);
-							//DEBUG_VECTOR_DOUBLE(ID, "Solution sent to parent", commSendHbToParent, n * pSize);
-						}
+						DEBUG_TEXT("TH[%i] trying to send best value to parent TH[%i].\n", ID, parentTH);
+						DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to parent TH[%i].\n", ID, parentTH);
+						// If the previous send has not completed yet, the value is sent on a later iteration.
+						commEngine->trySendToParent(generalBest, commStatus);
 					}
 					else {
 						DEBUG_TEXT("TH[%i] no improvement to send to the parent TH[%i].\n", ID, parentTH);
@@ -1337,6 +1494,10 @@ public:
 					}
 				}
 
+				// Collect everything the parent and the children have sent since the last iteration.
+				// Only the last Solution sent by every peer is maintained.
+				commEngine->poll();
+
 				// ---------------------------------
 				// If this TH instance has Children.
 				// ---------------------------------
@@ -1345,192 +1506,58 @@ public:
 				hasChildrenImproved = false;
 				popSeq = 1;
 				// Send global best to the active children.
-				if(currNode->hasChildren()){
-					// Communicate with active children.
-					for(i=0; i < nChildren && popSeq < populationSize; popSeq++){
-
-						if(childrenStatuses[i] == -2){
-							i++; popSeq--;
-							continue;
-						}
-						DEBUG_TEXT("TH[%i]'s child TH[%i] last status is %i.\n", ID, childrenTHs[i], childrenStatuses[i]);
-						DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] last status is %i.\n", ID, childrenTHs[i], childrenStatuses[i]);
-
-						// If there is a previous asynchronous read request for this child.
-						if(reqReadHhFromChildren[i*3] != NULL) {
-							// Check if previous read has been completed.
-							DEBUG_TEXT("TH[%i] checking if best value from child TH[%i] has been read.\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i] checking if best value from child TH[%i] has been read.\n", ID, childrenTHs[i]);
-							if(MPI_Testall(3, &reqReadHhFromChildren[i*3], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-								DEBUG_TEXT("TH[%i] error obtaining best value from child TH[%i].\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] error obtaining best value from child TH[%i].\n", ID, childrenTHs[i]);
-								exit(1);
-							}
-						}
-						else commFlag = 2; // If there is no pending read, force a new read request.
-
-						// If there is a read request for current child, but read has not completed.
-						if(!commFlag){
-							i++; popSeq--;
-							continue;
+				if(hasChildren){
+					// Process the data received from the children.
+					for(i=0; i < nChildren && popSeq < populationSize; i++){
+						DEBUG_TEXT("TH[%i]'s child TH[%i] last status is %i.\n", ID, childrenTHs[i], commEngine->getChildStatus(i));
+						DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] last status is %i.\n", ID, childrenTHs[i], commEngine->getChildStatus(i));
+						if(!commEngine->hasNewFromChild(i)) continue;
+
+						// The solution received is lent by the communication engine until the next poll,
+						// so the local search is performed directly over it.
+						childBest = commEngine->takeFromChild(i);
+
+						// Local search over children's data.
+						DEBUG_TEXT("TH[%i]'s performing local search over child's results TH[%i] with fitness %f...\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue());
+						DEBUG2FILE_TEXT(ID, "TH[%i]'s performing local search over child's results TH[%i] with fitness %f...\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue());
+						localSearchAlgorithm->setPopulation(&childBest, 1);
+						localSearchAlgorithm->startup();
+						localSearchAlgorithm->next(max(convergenceControlPolicy->getBudgetSize()/100, 1));
+						config->incrementEvals(localSearchAlgorithm->getCurrentNEvals());
+						DEBUG_TEXT("TH[%i]'s local search over child's results TH[%i] performed, obtained fitness %f. Current evals=%ld.\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue(), (long)config->getNEvals());
+						DEBUG2FILE_TEXT(ID, "TH[%i]'s local search over child's results TH[%i] performed, obtained fitness %f. Current evals=%ld.\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue(), (long)config->getNEvals());
+						//DEBUG_SOLUTION_DOUBLE(ID, "Local search performed over child's result", &childBest, 1, n);
+
+						*childBest = localSearchAlgorithm->getBestIndividual();
+						if(fitnessPolicy->firstIsBetter(childBest, generalBest)){
+							*generalBest = childBest;
+							hasChildrenImproved = true;
 						}
+						config->getBestListUpdatePolicy()->apply(bestList, childBest, fitnessPolicy);
 
-						// Empty current child's inbound communication channel, given the child could have
-						// sent data more than once since last asynchronous read.
-						// Only the last read data is maintained.
-						hasReadValue = false;
-						while(commFlag){
-							// If there is a previous asynchronous read request for this child, read the communication buffer.
-							if(reqReadHhFromChildren[i*3] == MPI_REQUEST_NULL){
-								// The communication buffer must be emptied so it can be reused for the next communication.
-								COPY_ARR(&commReadHhFitFromChildren[i * fSize], &HhFit[i * fSize], fSize);
-								COPY_ARR(commReadHhFromChildren[i], Hh[i], n * pSize);
-								childrenStatuses[i] = commChildrenStatuses[i];
-								DEBUG_TEXT("TH[%i] obtained best value from child TH[%i] whose status is now [%i].\n", ID, childrenTHs[i], childrenStatuses[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] obtained best value from child TH[%i] whose status is now [%i].\n", ID, childrenTHs[i], childrenStatuses[i]);
-								//DEBUG_VECTOR_DOUBLE(ID, "Child best value", Hh[i], n * pSize);
-								hasReadValue = true;
-							}
-							// If current child is still active.
-							if(childrenStatuses[i] > -2){
-								// Issue a new asynchronous read request.
-								DEBUG_TEXT("TH[%i] trying to obtain best value from child TH[%i].\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] trying to obtain best value from child TH[%i].\n", ID, childrenTHs[i]);
-								MPI_Irecv(commReadHhFromChildren[i], n * pSize, MpiTypeTraits<P>::GetType(), childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3]);
-								MPI_Irecv(&commReadHhFitFromChildren[i * fSize], fSize, MpiTypeTraits<F>::GetType(), childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3+1]);
-								MPI_Irecv(&commChildrenStatuses[i], 1, MPI_INT, childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3+2]);
-								usleep(10); // Give time for the read request to make effect.
-
-								// Check if previous read request has already completed.
-								if(MPI_Testall(3, &reqReadHhFromChildren[i*3], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-									DEBUG_TEXT("TH[%i] error obtaining best value from child TH[%i].\n", ID, childrenTHs[i]);
-									DEBUG2FILE_TEXT(ID, "TH[%i] error obtaining best value from child TH[%i].\n", ID, childrenTHs[i]);
-									exit(1);
-								}
-							}
-							else {
-								DEBUG_TEXT("TH[%i] child TH[%i] has completed the optimization.\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] child TH[%i] has completed the optimization.\n", ID, childrenTHs[i]);
-								commFlag = 0; // If child has been deactivated, there is no more data to read.
-							}
-						}
-
-						// In the case the child has not started yet.
-						if(childrenStatuses[i] == 0){
-							DEBUG_TEXT("TH[%i]'s child TH[%i] has not started yet.\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] has not started yet.\n", ID, childrenTHs[i]);
-							i++; popSeq--;
-							continue;
-						}
-
-						if(hasReadValue) {
-							*childBest = Hh[i];
-							childBest->setFitness(&HhFit[i * fSize]);
-
-							// Local search over children's data.
-							DEBUG_TEXT("TH[%i]'s performing local search over child's results TH[%i] with fitness %f...\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue());
-							DEBUG2FILE_TEXT(ID, "TH[%i]'s performing local search over child's results TH[%i] with fitness %f...\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue());
-							localSearchAlgorithm->setPopulation(&childBest, 1);
-							localSearchAlgorithm->startup();
-							localSearchAlgorithm->next(max(convergenceControlPolicy->getBudgetSize()/100, 1));
-							config->incrementEvals(localSearchAlgorithm->getCurrentNEvals());
-							DEBUG_TEXT("TH[%i]'s local search over child's results TH[%i] performed, obtained fitness %f. Current evals=%ld.\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue(), (long)config->getNEvals());
-							DEBUG2FILE_TEXT(ID, "TH[%i]'s local search over child's results TH[%i] performed, obtained fitness %f. Current evals=%ld.\n", ID, childrenTHs[i], childBest->getFitness()->getFirstValue(), (long)config->getNEvals());
-							//DEBUG_SOLUTION_DOUBLE(ID, "Local search performed over child's result", &childBest, 1, n);
-
-							*childBest = localSearchAlgorithm->getBestIndividual();
-							if(fitnessPolicy->firstIsBetter(childBest, generalBest)){
-								*generalBest = childBest;
-								hasChildrenImproved = true;
-							}
-							config->getBestListUpdatePolicy()->apply(bestList, childBest, fitnessPolicy);
-
-							// Flush the communication data to a population member.
-							*population[popSeq] = childBest;
-						}
-						else popSeq--;
-
-						i++;
+						// Flush the communication data to a population member.
+						*population[popSeq++] = childBest;
 					}
 
 					// Select a solution from best list.
 					*selectedFromBestList = config->getBestListSelectionPolicy()->apply(bestList, fitnessPolicy);
 					// Send the selected solution to all children.
 					for(i=0; i < nChildren; i++){
-						if(childrenStatuses[i] < 0) continue; // Ignore inactive children.
-						// If there is a previous asynchronous send request for this child.
-						if(reqSendToChildren[i*2] != NULL) {
-							// Check if previous send has been completed.
-							DEBUG_TEXT("TH[%i] checking if child TH[%i] received the selected random value from best list.\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i] checking if child TH[%i] received the selected random value from best list.\n", ID, childrenTHs[i]);
-							if(MPI_Testall(2, &reqSendToChildren[i*2], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-								DEBUG_TEXT("TH[%i] error sending a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] error sending a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
-								exit(1);
-							}
-						}
-						else commFlag = 2; // If there is no pending request for send, force a new send request.
-						// If all data has been sent to this child, send the currently selected solution from best list.
-						if(commFlag == 2 || (reqSendToChildren[i*2] == MPI_REQUEST_NULL && commFlag)){
-							selectedFromBestList->getPositions(commSendToChildren[i]);
-							selectedFromBestList->getFitness(&commSendFitToChildren[i * fSize]);
-							DEBUG_TEXT("TH[%i] trying to send a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i] trying to send a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
-							MPI_Isend(commSendToChildren[i], n * pSize, MpiTypeTraits<P>::GetType(), childrenTHs[i], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[i*2]);
-							MPI_Isend(&commSendFitToChildren[i * fSize], fSize, MpiTypeTraits<F>::GetType(), childrenTHs[i], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[i*2+1]);
-							//DEBUG_VECTOR_DOUBLE(ID, "Solution from best-list sent to children", commSendToChildren[i], n * pSize);
-						}
+						if(commEngine->getChildStatus(i) < 0) continue; // Ignore inactive children.
+						DEBUG_TEXT("TH[%i] trying to send a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
+						DEBUG2FILE_TEXT(ID, "TH[%i] trying to send a random value from best list to child TH[%i].\n", ID, childrenTHs[i]);
+						commEngine->trySendToChild(i, selectedFromBestList);
 					}
 				}
 
 				// -------------------------------
 				// If this TH instance has Parent.
 				// -------------------------------
-				if(currNode->hasParent() && t > 1){
-					// If there is a previous asynchronous read request for the parent.
-					if(reqReadHHbFromParent[0] != NULL) {
-						// Check if previous read has been completed.
-						DEBUG_TEXT("TH[%i] checking if parent's (TH[%i]) best position has been received.\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] checking if parent's (TH[%i]) best position has been received.\n", ID, parentTH);
-						if(MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-							DEBUG_TEXT("TH[%i] error receiving parent's best position from TH[%i].\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] error receiving parent's best position from TH[%i].\n", ID, parentTH);
-							exit(1);
-						}
-					}
-					else commFlag = 2; // If there is no pending request for read, force a new read request.
-					// If data has been read from the parent, make a new request for read.
-					hasReadValue = false;
-					while(commFlag){
-						// If there is a previous asynchronous read request for the parent, read the communication buffer.
-						if(reqReadHHbFromParent[0] == MPI_REQUEST_NULL){
-							COPY_ARR(commReadHHbFromParent, HHb, n * pSize);
-							COPY_ARR(commReadHHbFitFromParent, HHbFit, fSize);
-							DEBUG_TEXT("TH[%i] received parent's best position from TH[%i].\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] received parent's best position from TH[%i].\n", ID, parentTH);
-							//DEBUG_VECTOR_DOUBLE(ID, "Solution received from parent", commReadHHbFromParent, n * pSize);
-							hasReadValue = true;
-						}
-						DEBUG_TEXT("TH[%i] trying to receive parent's best position from TH[%i].\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] trying to receive parent's best position from TH[%i].\n", ID, parentTH);
-						MPI_Irecv(commReadHHbFromParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[0]);
-						MPI_Irecv(commReadHHbFitFromParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[1]);
-						usleep(10); // Give time for the read request to make effect.
-						// If previous receive has already completed.
-						if(MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-							DEBUG_TEXT("TH[%i] error receiving parent's best position from TH[%i].\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] error receiving parent's best position from TH[%i].\n", ID, parentTH);
-							exit(1);
-						}
-					}
-					if(hasReadValue) {
-						*parentBest = HHb;
-						parentBest->setFitness(HHbFit);
-					}
-					else *parentBest = generalBest;
+				if(hasParent && t > 1 && commEngine->hasNewFromParent()){
+					parentBest = commEngine->takeFromParent();
 				}
 				else{
-					*parentBest = generalBest;
+					parentBest = generalBest;
 				}
 
 				if(bias != NULL && popSeq < populationSize) {
@@ -1548,7 +1575,7 @@ public:
 					iterationData->setCurrIteration(t);
 					iterationData->setCurrNumberEvaluation(config->getNEvals());
 					iterationData->setCurrTime(config->getElapsedSeconds());
-					iterationData->setPopulation(population, populationSize);
+					iterationData->setPopulation(searchGroup->getPopulationStore());
 					iterationData->setGeneralBest(generalBest);
 					iterationData->setParentBest(parentBest);
 					iterationData->setIterationBest(searchGroup->getIterationBest());
@@ -1561,14 +1588,13 @@ public:
 							subRegion, thTree, ID
 						);
 
-						config->getRelocationStrategyPolicy()->apply(relocationStrategyData,
-								subRegion, &population[popSeq], populationSize-popSeq);
+						config->getRelocationStrategyPolicy()->applyRange(relocationStrategyData,
+								subRegion, searchGroup->getPopulationStore(), popSeq);
 
 						// Calculate the fitness for the new solutions.
-						for(; popSeq < populationSize; popSeq++){
-							fitnessPolicy->apply(population[popSeq]);
-							config->incrementEvals(1);
-						}
+						fitnessPolicy->applyBatch(&population[popSeq], populationSize-popSeq);
+						config->incrementEvals(populationSize-popSeq);
+						popSeq = populationSize;
 						DEBUG_TEXT("TH[%i]'s individuals relocated.\n", ID);
 						DEBUG2FILE_TEXT(ID, "TH[%i]'s individuals relocated.\n", ID);
 					}
@@ -1578,9 +1604,14 @@ public:
 				DEBUG_TEXT("TH[%i] T=%i, maxNumberEvaluations=%i, maxTimeSeconds=%i, startTime=%i, currTime=%i.\n", ID, T, maxNumberEvaluations, maxTimeSeconds, (int)startTime.tv_sec, (int)currTime.tv_sec);
 				DEBUG2FILE_TEXT(ID, "TH[%i] T=%i, maxNumberEvaluations=%i, maxTimeSeconds=%i, startTime=%i, currTime=%i.\n", ID, T, maxNumberEvaluations, maxTimeSeconds, (int)startTime.tv_sec, (int)currTime.tv_sec);
 
+#ifdef TH_COUNT_ALLOCATIONS
+				// The first iteration warms up the lazily created objects.
+				if(t > 1) steadyStateAllocations += THAllocationCounter::count().load() - allocations;
+#endif
 				t++; // Increment the iteration.
 
 			}while(runNextIteration);
+			commEngine->stopThread();
 
 			// -----------------------
 			// Residual Communication.
@@ -1588,196 +1619,72 @@ public:
 			DEBUG_TEXT("TH[%i] search phase completed.\n", ID);
 			DEBUG2FILE_TEXT(ID, "TH[%i] search phase completed.\n", ID);
 
-			if(currNode->hasParent()){
+			if(hasParent){
 				// Discard remaining data sent by the parent.
 				// From this point on, this sub-tree will focus only in the search intensification.
-				if(reqReadHHbFromParent[0] != NULL) {// && reqReadHHbFromParent[0] != MPI_REQUEST_NULL) {
-					DEBUG_TEXT("TH[%i] trying to discard parent's data (TH[%i]).\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] trying to discard parent's data (TH[%i]).\n", ID, parentTH);
-					MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE);
-				}
-				else commFlag = 2;
-				while(commFlag){
-					DEBUG_TEXT("TH[%i] discarding parent's data (TH[%i]).\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] discarding parent's data (TH[%i]).\n", ID, parentTH);
-					MPI_Irecv(commReadHHbFromParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[0]);
-					MPI_Irecv(commReadHHbFitFromParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[1]);
-					if(MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-						DEBUG_TEXT("TH[%i] error discarding parent's data (TH[%i]).\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] error discarding parent's data (TH[%i]).\n", ID, parentTH);
-						exit(1);
-					}
-					//DEBUG_VECTOR_DOUBLE(ID, "Parent data discarded", commReadHHbFromParent, n * pSize);
-				}
+				DEBUG_TEXT("TH[%i] discarding parent's data (TH[%i]).\n", ID, parentTH);
+				DEBUG2FILE_TEXT(ID, "TH[%i] discarding parent's data (TH[%i]).\n", ID, parentTH);
+				commEngine->discardParent();
 
 				// Inform the parent this TH instance is entering the Residual Communication phase.
+				// If parent is not available to receive, the data is sent later.
 				commStatus = -1;
-				if(reqSendHbToParent[0] != NULL) {// && reqSendHbToParent[0] != MPI_REQUEST_NULL) {
-					DEBUG_TEXT("TH[%i] trying to send best value to parent (TH[%i]).\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to parent (TH[%i]).\n", ID, parentTH);
-					MPI_Testall(3, reqSendHbToParent, &commFlag,  MPI_STATUSES_IGNORE);
-				}
-				else commFlag = 2;
-				if(commFlag){ // If parent is not available to receive, send the data later.
-					// Send global best to the parent.
-					generalBest->getPositions(commSendHbToParent);
-					generalBest->getFitness(commSendHbFitToParent);
-					DEBUG_TEXT("TH[%i] sending best value to parent (TH[%i]).\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] sending best value to parent (TH[%i]).\n", ID, parentTH);
-					MPI_Isend(commSendHbToParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[0]);
-					MPI_Isend(commSendHbFitToParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[1]);
-					MPI_Isend(&commStatus, 1, MPI_INT, parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[2]);
-					//DEBUG_VECTOR_DOUBLE(ID, "Best value sent to parent", commSendHbToParent, n * pSize);
-				}
+				DEBUG_TEXT("TH[%i] trying to send best value to parent (TH[%i]).\n", ID, parentTH);
+				DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to parent (TH[%i]).\n", ID, parentTH);
+				commEngine->trySendToParent(generalBest, commStatus);
 			}
 
-			if(currNode->hasChildren()){
+			if(hasChildren){
 				// Send global best to children.
 				for(i=0; i < nChildren; i++){
-					if(childrenStatuses[i] < 0) continue; // Ignore inactive children.
-					// If there is a previous asynchronous send request for this child.
-					if(reqSendToChildren[i*2] != NULL) {// && reqSendToChildren[i*2] != MPI_REQUEST_NULL) {
-						// Check if previous send has been completed.
-						DEBUG_TEXT("TH[%i] checking if best value has been sent to child TH[%i].\n", ID, childrenTHs[i]);
-						DEBUG2FILE_TEXT(ID, "TH[%i] checking if best value has been sent to child TH[%i].\n", ID, childrenTHs[i]);
-						if(MPI_Testall(2, &reqSendToChildren[i*2], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-							DEBUG_TEXT("TH[%i] error sending best value to child TH[%i].\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i] error sending best value to child TH[%i].\n", ID, childrenTHs[i]);
-							exit(1);
-						}
-					}
-					else commFlag = 2; // If there is no pending request for send, force a new send request.
-					// If all data has been sent to this child, send the global best value.
-					if(commFlag){
-						generalBest->getPositions(commSendToChildren[i]);
-						generalBest->getFitness(&commSendFitToChildren[i * fSize]);
-						DEBUG_TEXT("TH[%i] trying to send best value to child TH[%i].\n", ID, childrenTHs[i]);
-						DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to child TH[%i].\n", ID, childrenTHs[i]);
-						MPI_Isend(commSendToChildren[i], n * pSize, MpiTypeTraits<P>::GetType(), childrenTHs[i], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[i*2]);
-						MPI_Isend(&commSendFitToChildren[i * fSize], fSize, MpiTypeTraits<F>::GetType(), childrenTHs[i], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[i*2+1]);
-						//DEBUG_VECTOR_DOUBLE(ID, "General best sent to children", commSendToChildren[i], n * pSize);
-					}
+					if(commEngine->getChildStatus(i) < 0) continue; // Ignore inactive children.
+					DEBUG_TEXT("TH[%i] trying to send best value to child TH[%i].\n", ID, childrenTHs[i]);
+					DEBUG2FILE_TEXT(ID, "TH[%i] trying to send best value to child TH[%i].\n", ID, childrenTHs[i]);
+					commEngine->trySendToChild(i, generalBest);
 				}
 
 				int nInactiveChild = 0;
 				Solution<P, pSize, F, fSize, V, vSize> tmpMember(n);
 				// Wait all children to finish.
-				do{
-					usleep(1000000); // Wait 1 second.
+				while(true){
 					DEBUG_TEXT("TH[%i] has %i children to check.\n", ID, nChildren-nInactiveChild);
 					for(nInactiveChild=0, i=0; i < nChildren; i++){
-						// Ignore inactive children.
-						if(childrenStatuses[i] == -2){
-							nInactiveChild++; continue;
-						}
-
-						// If there is a previous asynchronous read request for this child.
-						if(reqReadHhFromChildren[i*3] != NULL) {// && reqReadHhFromChildren[i*3] != MPI_REQUEST_NULL) {
-							DEBUG_TEXT("TH[%i] waiting to hear from its child TH[%i].\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i] waiting to hear from its child TH[%i].\n", ID, childrenTHs[i]);
-							// Check if previous read has been completed.
-							if(MPI_Testall(3, &reqReadHhFromChildren[i*3], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-								DEBUG_TEXT("TH[%i] error hearing from its child TH[%i].\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] error hearing from its child TH[%i].\n", ID, childrenTHs[i]);
-								exit(1);
-							}
-						}
-						else commFlag = 2; // If there is no pending request for read, force a new read request.
-
-						// Empty current child's inbound communication channel, given the child could have
-						// sent data more than once since last asynchronous read.
-						// Only the last read data is maintained.
-						hasReadValue = false;
-						while(commFlag){
-							// If there is a previous asynchronous read request for this child, read the communication buffer.
-							if(reqReadHhFromChildren[i*3] == MPI_REQUEST_NULL){
-								// The communication buffer must be emptied so it can be reused for the next communication.
-								COPY_ARR(commReadHhFromChildren[i], Hh[i], n * pSize);
-								COPY_ARR(&commReadHhFitFromChildren[i * fSize], &HhFit[i * fSize], fSize);
-								childrenStatuses[i] = commChildrenStatuses[i];
-								DEBUG_TEXT("TH[%i] obtained information from child TH[%i].\n", ID, childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] obtained information from child TH[%i].\n", ID, childrenTHs[i]);
-								//DEBUG_VECTOR_DOUBLE(ID, "Child best value", Hh[i], n * pSize);
-								hasReadValue = true;
-							}
-							// If current child is still active.
-							if(childrenStatuses[i] > -2){
-								// Issue a new asynchronous read request.
-								MPI_Irecv(commReadHhFromChildren[i], n * pSize, MpiTypeTraits<P>::GetType(), childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3]);
-								MPI_Irecv(&commReadHhFitFromChildren[i * fSize], fSize, MpiTypeTraits<F>::GetType(), childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3+1]);
-								MPI_Irecv(&commChildrenStatuses[i], 1, MPI_INT, childrenTHs[i], MSG_CHILD2PARENT, cartGrid, &reqReadHhFromChildren[i*3+2]);
-								DEBUG_TEXT("TH[%i] requesting new information from child TH[%i].\n", ID, childrenTHs[i])
-								DEBUG2FILE_TEXT(ID, "TH[%i] requesting new information from child TH[%i].\n", ID, childrenTHs[i])
-								usleep(10); // Give time for the read request to make effect.
-								// Check if previous read request has already completed.
-								if(MPI_Testall(3, &reqReadHhFromChildren[i*3], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-									DEBUG_TEXT("TH[%i] error requesting new information from child TH[%i].\n", ID, childrenTHs[i]);
-									DEBUG2FILE_TEXT(ID, "TH[%i] error requesting new information from child TH[%i].\n", ID, childrenTHs[i]);
-									exit(1);
-								}
-							}
-							else commFlag = 0; // If child has been deactivated, there is no more data to read.
-						}
-						if(childrenStatuses[i] == -2){
-							nInactiveChild++;
-							DEBUG_TEXT("TH[%i]'s child TH[%i] is now inactive.\n", ID, childrenTHs[i]);
-							DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] is now inactive.\n", ID, childrenTHs[i]);
-						}
-						if(hasReadValue){
-							tmpMember = Hh[i];
-							tmpMember.setFitness(&HhFit[i * fSize]);
+						if(commEngine->hasNewFromChild(i)){
+							DEBUG_TEXT("TH[%i] obtained information from child TH[%i].\n", ID, childrenTHs[i]);
+							DEBUG2FILE_TEXT(ID, "TH[%i] obtained information from child TH[%i].\n", ID, childrenTHs[i]);
+							tmpMember = commEngine->takeFromChild(i);
 							if(fitnessPolicy->firstIsBetter(&tmpMember, generalBest)){
-								DEBUG_TEXT("TH[%i] obtained better information [%f] from child TH[%i].\n", ID, HhFit[i * fSize], childrenTHs[i]);
-								DEBUG2FILE_TEXT(ID, "TH[%i] obtained better information [%f] from child TH[%i].\n", ID, HhFit[i * fSize], childrenTHs[i]);
+								DEBUG_TEXT("TH[%i] obtained better information [%f] from child TH[%i].\n", ID, tmpMember.getFitness()->getFirstValue(), childrenTHs[i]);
+								DEBUG2FILE_TEXT(ID, "TH[%i] obtained better information [%f] from child TH[%i].\n", ID, tmpMember.getFitness()->getFirstValue(), childrenTHs[i]);
 								*generalBest = &tmpMember;
 
 								//----------------
 								// Send to parent.
-								if(currNode->hasParent()){
-									DEBUG_TEXT("TH[%i] checking if parent TH[%i] has read the last information from child TH[%i].\n", ID, parentTH, childrenTHs[i]);
-									DEBUG2FILE_TEXT(ID, "TH[%i] checking if parent TH[%i] has read the last information from child TH[%i].\n", ID, parentTH, childrenTHs[i]);
-									if(MPI_Testall(3, reqSendHbToParent, &commFlag,  MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-										DEBUG_TEXT("TH[%i] error redirecting child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
-										DEBUG2FILE_TEXT(ID, "TH[%i] error redirecting child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
-										exit(1);
-									}
-									if(commFlag){
-										generalBest->getPositions(commSendHbToParent);
-										generalBest->getFitness(commSendHbFitToParent);
-										DEBUG_TEXT("TH[%i] trying to redirect child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
-										DEBUG2FILE_TEXT(ID, "TH[%i] trying to redirect child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
-										MPI_Isend(commSendHbToParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[0]);
-										MPI_Isend(commSendHbFitToParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[1]);
-										MPI_Isend(&commStatus, 1, MPI_INT, parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[2]);
-										//DEBUG_VECTOR_DOUBLE(ID, "Child's solution redirected to parent", commSendHbToParent, n * pSize);
-									}
+								if(hasParent){
+									DEBUG_TEXT("TH[%i] trying to redirect child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
+									DEBUG2FILE_TEXT(ID, "TH[%i] trying to redirect child's TH[%i] information to parent TH[%i].\n", ID, childrenTHs[i], parentTH);
+									commEngine->trySendToParent(generalBest, commStatus);
 								}
 
 								// Send to children.
-								if(currNode->hasChildren()){
-									for(int j=0; j < nChildren; j++){
-										if(j == i || childrenStatuses[j] < 0) continue; // Except to the children that just sent the solution.
-										DEBUG_TEXT("TH[%i] checking if last sent information has been read by child TH[%i].\n", ID, childrenTHs[j]);
-										DEBUG2FILE_TEXT(ID, "TH[%i] checking if last sent information has been read by child TH[%i].\n", ID, childrenTHs[j]);
-										if(MPI_Testall(2, &reqSendToChildren[j*2], &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-											DEBUG_TEXT("TH[%i] error redirecting child's TH[%i] information to child TH[%i].\n", ID, childrenTHs[i], childrenTHs[j]);
-											exit(1);
-										}
-										if(commFlag){
-											generalBest->getPositions(commSendToChildren[j]);
-											generalBest->getFitness(&commSendFitToChildren[j * fSize]);
-											DEBUG_TEXT("TH[%i] trying to redirect child's TH[%i] information to child TH[%i].\n", ID, childrenTHs[i], childrenTHs[j]);
-											DEBUG2FILE_TEXT(ID, "TH[%i] trying to redirect child's TH[%i] information to child TH[%i].\n", ID, childrenTHs[i], childrenTHs[j]);
-											MPI_Isend(commSendToChildren[j], n * pSize, MpiTypeTraits<P>::GetType(), childrenTHs[j], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[j*2]);
-											MPI_Isend(&commSendFitToChildren[j * fSize], fSize, MpiTypeTraits<F>::GetType(), childrenTHs[j], MSG_PARENT2CHILD, cartGrid, &reqSendToChildren[j*2+1]);
-											//DEBUG_VECTOR_DOUBLE(ID, "Child's solution redirected to remaining children", commSendToChildren[j], n * pSize);
-										}
-									}
+								for(int j=0; j < nChildren; j++){
+									if(j == i || commEngine->getChildStatus(j) < 0) continue; // Except to the children that just sent the solution.
+									DEBUG_TEXT("TH[%i] trying to redirect child's TH[%i] information to child TH[%i].\n", ID, childrenTHs[i], childrenTHs[j]);
+									DEBUG2FILE_TEXT(ID, "TH[%i] trying to redirect child's TH[%i] information to child TH[%i].\n", ID, childrenTHs[i], childrenTHs[j]);
+									commEngine->trySendToChild(j, generalBest);
 								}
 							}
 						}
+						if(commEngine->getChildStatus(i) == -2){
+							nInactiveChild++;
+							DEBUG_TEXT("TH[%i]'s child TH[%i] is inactive.\n", ID, childrenTHs[i]);
+							DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] is inactive.\n", ID, childrenTHs[i]);
+						}
 					}
-				}while(nInactiveChild < nChildren);
+					if(nInactiveChild == nChildren) break;
+					// Sleep inside MPI until any peer sends something new.
+					commEngine->waitSome();
+				}
 			}
 
 			// Print Section.
@@ -1786,84 +1693,40 @@ public:
 			DEBUG2FILE_TEXT_IF(ID, nChildren>0, "TH[%i]'s children finished. Finishing as well...\n", ID);
 
 			// Send the final global best solution to the parent.
-			if(currNode->hasParent()){
-				// Wait until the parent has read all messages sent by this TH instance.
-				if(MPI_Testall(3, reqSendHbToParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-					DEBUG_TEXT("TH[%i] error waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] error waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-					exit(1);
-				}
-				while(!commFlag){
-					DEBUG_TEXT("TH[%i] waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-					usleep(1000000); // Wait 1 second.
-					if(MPI_Testall(3, reqSendHbToParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-						DEBUG_TEXT("TH[%i] error waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] error waiting for parent TH[%i] to read the last package.\n", ID, parentTH);
-						exit(1);
-					}
-				}
-				generalBest->getPositions(commSendHbToParent);
-				generalBest->getFitness(commSendHbFitToParent);
+			if(hasParent){
 				DEBUG_TEXT("TH[%i] Trying to send last best value and inform to parent TH[%i] that this instance has finished.\n", ID, parentTH);
 				DEBUG2FILE_TEXT(ID, "TH[%i] Trying to send last best value and inform to parent TH[%i] that this instance has finished.\n", ID, parentTH);
 				commStatus = -2; // Notify the parent this TH instance is shutting down.
-				MPI_Isend(commSendHbToParent, n * pSize, MpiTypeTraits<P>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[0]);
-				MPI_Isend(commSendHbFitToParent, fSize, MpiTypeTraits<F>::GetType(), parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[1]);
-				MPI_Isend(&commStatus, 1, MPI_INT, parentTH, MSG_CHILD2PARENT, cartGrid, &reqSendHbToParent[2]);
+				commEngine->sendToParent(generalBest, commStatus); // Wait until the parent has read the previous package.
 				DEBUG_TEXT("TH[%i] Sent last best value to parent TH[%i].\n", ID, parentTH);
 				DEBUG2FILE_TEXT(ID, "TH[%i] Sent last best value to parent TH[%i].\n", ID, parentTH);
 			}
 
 			// Wait the children to read all data packages sent.
-			if(currNode->hasChildren()){
-				for(i=0; i < nChildren; i++){
-					DEBUG_TEXT("TH[%i] waiting for child TH[%i] to read the last package.\n", ID, childrenTHs[i]);
-					DEBUG2FILE_TEXT(ID, "TH[%i] waiting for child TH[%i] to read the last package.\n", ID, childrenTHs[i]);
-					MPI_Waitall(2, &reqSendToChildren[i*2], MPI_STATUSES_IGNORE);
-					DEBUG_TEXT("TH[%i]'s child TH[%i] did read all the packages.\n", ID, childrenTHs[i]);
-					DEBUG2FILE_TEXT(ID, "TH[%i]'s child TH[%i] did read all the packages.\n", ID, childrenTHs[i]);
-				}
+			if(hasChildren){
+				DEBUG_TEXT("TH[%i] waiting for the children to read the last package.\n", ID);
+				DEBUG2FILE_TEXT(ID, "TH[%i] waiting for the children to read the last package.\n", ID);
+				commEngine->flushChildren();
+				DEBUG_TEXT("TH[%i]'s children did read all the packages.\n", ID);
+				DEBUG2FILE_TEXT(ID, "TH[%i]'s children did read all the packages.\n", ID);
 			}
 
 			// ----------------------
 			// Finalize the sub-tree.
 			// ----------------------
 
-			// Wait for parent's finalization signal.
-			int signal = 0;
-	        if(currNode->hasParent()){
-	        	while(!signal) {
-	    			// Discard remaining parent data (starting by leaf nodes).
-					if(MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-						DEBUG_TEXT("TH[%i] error discarding parent's data TH[%i].\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] error discarding parent's data TH[%i].\n", ID, parentTH);
-						exit(1);
-					}
-					while(commFlag){
-						MPI_Irecv(commReadHHbFromParent, n, MPI_DOUBLE, parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[0]);
-						MPI_Irecv(commReadHHbFitFromParent, 1, MPI_DOUBLE, parentTH, MSG_PARENT2CHILD, cartGrid, &reqReadHHbFromParent[1]);
-						DEBUG_TEXT("TH[%i] discarding parent's data TH[%i].\n", ID, parentTH);
-						DEBUG2FILE_TEXT(ID, "TH[%i] discarding parent's data TH[%i].\n", ID, parentTH);
-						usleep(1000000);
-						if(MPI_Testall(2, reqReadHHbFromParent, &commFlag, MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
-							DEBUG_TEXT("TH[%i] error discarding parent's data TH[%i].\n", ID, parentTH);
-							DEBUG2FILE_TEXT(ID, "TH[%i] error discarding parent's data TH[%i].\n", ID, parentTH);
-							exit(1);
-						}
-					}
-
-	    			DEBUG_TEXT("TH[%i] waiting for finalization signal from parent TH[%i].\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] waiting for finalization signal from parent TH[%i].\n", ID, parentTH);
-					MPI_Irecv(&signal, 1, MPI_INT, parentTH, MSG_FINALIZE, cartGrid, &reqReadFinalize);
-					DEBUG_TEXT("TH[%i] received finalization signal from parent TH[%i].\n", ID, parentTH);
-					DEBUG2FILE_TEXT(ID, "TH[%i] received finalization signal from parent TH[%i].\n", ID, parentTH);
-					if(!signal) usleep(1000000); // Wait 1 second.
-	        	}
+			// Wait for parent's finalization signal, discarding the remaining parent data (starting by leaf nodes).
+	        if(hasParent){
+				DEBUG_TEXT("TH[%i] waiting for finalization signal from parent TH[%i].\n", ID, parentTH);
+				DEBUG2FILE_TEXT(ID, "TH[%i] waiting for finalization signal from parent TH[%i].\n", ID, parentTH);
+				commEngine->waitFinalization();
 			}
+			// All peers stopped exchanging Solutions with this TH instance.
+			commEngine->shutdown();
+
 			// Send finalization signal to children, starting from root node.
-	        signal = MSG_FINALIZE;
-			if(currNode->hasChildren()){
+			int signal = MSG_FINALIZE;
+			if(hasChildren){
                 for(i=0; i < nChildren; i++){
                 	DEBUG_TEXT("TH[%i] sending finalization signal to child TH[%i].\n", ID, childrenTHs[i]);
                 	DEBUG2FILE_TEXT(ID, "TH[%i] sending finalization signal to child TH[%i].\n", ID, childrenTHs[i]);
@@ -1875,7 +1738,7 @@ public:
 
 			if(thTree->getCurrentSize() > 1) {
 				// Leaf nodes reply the confirmation for the finalization signal.
-				if(currNode->isLeaf()){
+				if(!hasChildren){
 					DEBUG_TEXT("TH[%i] (leaf) sending back confirmation of finalization signal to parent TH[%i].\n", ID, parentTH);
 					DEBUG2FILE_TEXT(ID, "TH[%i] (leaf) sending back confirmation of finalization signal to parent TH[%i].\n", ID, parentTH);
 					MPI_Send(&signal, 1, MPI_INT, parentTH, MSG_FINALIZE, cartGrid);
@@ -1892,7 +1755,7 @@ public:
 						DEBUG2FILE_TEXT(ID, "TH[%i] received confirmation of finalization signal from child TH[%i].\n", ID, childrenTHs[i]);
 					}
 					// Parent nodes reply the confirmation for the finalization signal.
-					if(currNode->hasParent()){
+					if(hasParent){
 						DEBUG_TEXT("TH[%i] sending back confirmation of finalization signal to parent TH[%i].\n", ID, parentTH);
 						DEBUG2FILE_TEXT(ID, "TH[%i] sending back confirmation of finalization signal to parent TH[%i].\n", ID, parentTH);
 						MPI_Send(&signal, 1, MPI_INT, parentTH, MSG_FINALIZE, cartGrid);
@@ -1905,8 +1768,6 @@ public:
 			executed = true;
 			DEBUG_TEXT("TH[%i] execution finished.\n", ID);
 			DEBUG2FILE_TEXT(ID, "TH[%i] execution finished.\n", ID);
-			delete childBest;
-			delete selectedFromBestList;
 		}
 
 		/**
@@ -1954,6 +1815,10 @@ public:
 		long long getNEvals(){
 			return config->getNEvals();
 		}
+
+		long long getSteadyStateAllocations(){
+			return steadyStateAllocations;
+		}
 	};
 };
 
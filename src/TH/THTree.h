@@ -30,6 +30,11 @@
  *          THTree's node ID must be adjusted accordingly.
  *
  *          Notice it is mandatory to {@link lock()} the THTree topology before using it.
+ *
+ *          The TH instances only query the topology by node ID (level, parent, children and
+ *          position among the siblings), so sub-classes can answer these queries without
+ *          materializing the nodes (see {@link KAryTHTree}). The t_node based methods are
+ *          only available on the explicit topologies built with {@link addNode()}.
  */
 
 #ifndef TH_THTREE_H_
@@ -130,6 +135,18 @@ class THTree {
 		return ss;
 	}
 
+protected:
+	/**
+	 * @brief Constructor for sub-classes that do not store the nodes.
+	 */
+	THTree() {
+		limitSize = currSize = 0;
+		nodes = NULL;
+		root = NULL;
+		LRoot = 1;
+		locked = false;
+	}
+
 public:
 	/**
 	 * @brief Constructor to create a tree topology with a fixed number of nodes.
@@ -147,11 +164,11 @@ public:
 		LRoot = 1;
 		locked = false;
 	}
-	~THTree(){
+	virtual ~THTree(){
 		for(int i=0; i < limitSize; i++){
 			delete nodes[i];
 		}
-		delete nodes;
+		delete[] nodes;
 	}
 
 	/**
@@ -199,7 +216,7 @@ public:
 	 * The lock is Mandatory before using the topology since
 	 * it will pack internal references.
 	 */
-	void lock(){
+	virtual void lock(){
 		locked = true;
 		// Pack the tree level.
 		if(root->getLevel() != LRoot) pack(root, LRoot);
@@ -209,15 +226,24 @@ public:
 		return root;
 	}
 
+	/**
+	 * @brief Get the ID of the root node.
+	 * @return The root's ID, or -1 if there is no root node yet.
+	 */
+	virtual int getRootID() {
+		if(root != NULL) return root->getID();
+		return -1;
+	}
+
 	t_node* getNode(int ID) {
 		return nodeMap.at(ID);
 	}
 
-	int getRootLevel() {
+	virtual int getRootLevel() {
 		return LRoot;
 	}
 
-	int getLevel(int ID) {
+	virtual int getLevel(int ID) {
 		t_node* node = getNode(ID);
 		if(node != NULL) return node->getLevel();
 		return -1;
@@ -229,7 +255,11 @@ public:
 		return NULL;
 	}
 
-	int getParentID(int ID) {
+	/**
+	 * @brief Get the ID of the parent node.
+	 * @return The parent's ID, or -1 for the root node.
+	 */
+	virtual int getParentID(int ID) {
 		t_node* parent = getParent(ID);
 		if(parent != NULL) return parent->getID();
 		return -1;
@@ -241,7 +271,10 @@ public:
 		return NULL;
 	}
 
-	void getChildrenIDs(int ID, std::vector<int>* IDs) {
+	/**
+	 * @brief Append the IDs of the children nodes to IDs, in the order they were added.
+	 */
+	virtual void getChildrenIDs(int ID, std::vector<int>* IDs) {
 		if(IDs == NULL) return;
 		std::vector<t_node*> *children = getChildren(ID);
 		for(t_node* child : *children) {
@@ -249,15 +282,33 @@ public:
 		}
 	}
 
+	virtual int getNChildren(int ID) {
+		return getNode(ID)->getNChildren();
+	}
+
+	/**
+	 * @brief Get the position of the node among its parent's children.
+	 * @return The position (starting at 0), or -1 for the root node.
+	 */
+	virtual int getChildPosition(int ID) {
+		t_node* parent = getParent(ID);
+		if(parent == NULL) return -1;
+		std::vector<t_node*> *siblings = parent->getChildren();
+		for(int pos=0; pos < (int)siblings->size(); pos++) {
+			if((*siblings)[pos]->getID() == ID) return pos;
+		}
+		return -1;
+	}
+
 	/**
 	 * @brief Get the tree topology size.
 	 * @return The number of nodes in the tree.
 	 */
-	int getCurrentSize() {
+	virtual int getCurrentSize() {
 		return currSize;
 	}
 
-	void print() {
+	virtual void print() {
 		print(root);
 	}
 
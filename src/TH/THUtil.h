@@ -34,8 +34,13 @@
 #include <fstream>
 #include <sys/stat.h>
 #include <libgen.h>
+#include <new>
+#include <atomic>
+#include <cmath>
 #include "macros.h"
 #include "config.h"
+#include "RandomEngine.h"
+#include "AllocationCounter.h"
 
 class THUtil{
 public:
@@ -43,13 +48,16 @@ public:
 	/**
 	 * @brief Get a random seed.
 	 *
-	 * For non unix-like environments, a sequential seed will be returned.
+	 * The system entropy (/dev/urandom) is read only once, and every seed is then
+	 * generated from it by SplitMix64.
+	 * For non unix-like environments, or when the deterministic behavior is configured,
+	 * a sequential seed will be returned.
 	 *
 	 * @return A random seed.
 	 */
 	static unsigned int getRandomSeed(){
-		static unsigned int randomSeq = 0;
-		unsigned int randVal;
+		static std::atomic<unsigned long long> randomSeq(0);
+		static const unsigned long long entropy = readEntropy();
 		bool random = true;
 
 #ifdef RANDBEHAVIOR
@@ -58,18 +66,24 @@ public:
 #endif
 #endif
 
-		int sizeRead = 0;
-		if(random) { // Cannot be inside an ifdef due to user configuration.
-			FILE *f = fopen("/dev/urandom", "r");
-			sizeRead = fread(&randVal, sizeof(randVal), 1, f);
-			fclose(f);
+		if(!random || entropy == 0) { // Cannot be inside an ifdef due to user configuration.
+			return (unsigned int)++randomSeq;
 		}
+		return (unsigned int)SplitMix64::mix(entropy + (++randomSeq) * 0x9E3779B97F4A7C15ULL);
+	}
 
-		if(!random || sizeRead == 0){
-			randVal = ++randomSeq;
+	/**
+	 * @brief Read 64 bits from the system entropy.
+	 * @return The entropy read, or zero if it is not available.
+	 */
+	static unsigned long long readEntropy(){
+		unsigned long long entropy = 0;
+		FILE *f = fopen("/dev/urandom", "r");
+		if(f != NULL) {
+			if(fread(&entropy, sizeof(entropy), 1, f) != 1) entropy = 0;
+			fclose(f);
 		}
-
-		return randVal;
+		return entropy;
 	}
 
 	static void truncateFile(const char* fileName) {
@@ -145,13 +159,70 @@ public:
 		return buffer2; // Return the final buffer, that must be freed up later.
 	}
 
-	static inline double randUniformDouble(unsigned int &seed, double a, double b) { return (a==b) ? a : (a+(((double)rand_r(&seed))/RAND_MAX)*(b-a)); }
+	/**
+	 * @brief Allocate a memory block aligned to the boundary provided.
+	 *
+	 * The memory block must be released through {@link alignedFree(void*)}.
+	 *
+	 * @param size The size of the memory block (in bytes).
+	 * @param alignment The memory alignment (in bytes), which must be a power of two.
+	 * @return A pointer to the aligned memory block.
+	 * @throws bad_alloc if the memory block cannot be allocated.
+	 */
+	static void* alignedAlloc(size_t size, size_t alignment = TH_MEMORY_ALIGNMENT) {
+		void *ptr = NULL;
+		if(posix_memalign(&ptr, alignment, (size > 0) ? size : alignment) != 0) {
+			throw std::bad_alloc();
+		}
+#ifdef TH_COUNT_ALLOCATIONS
+		THAllocationCounter::count().fetch_add(1, std::memory_order_relaxed);
+#endif
+		return ptr;
+	}
+
+	/**
+	 * @brief Release a memory block allocated by {@link alignedAlloc(size_t, size_t)}.
+	 * @param ptr The pointer to the memory block.
+	 */
+	static void alignedFree(void *ptr) {
+		free(ptr);
+	}
+
+	/**
+	 * @brief Advance the seed and get the next random 32-bit number.
+	 *
+	 * The seed works as a Weyl sequence whose values are scrambled by the MurmurHash3 finalizer,
+	 * so the next number only depends on the current seed (which is updated on every call).
+	 *
+	 * @param seed The seed, updated on every call.
+	 * @return The random number.
+	 */
+	static inline unsigned int randNext(unsigned int &seed) {
+		unsigned int z = (seed += 0x9E3779B9U);
+		z = (z ^ (z >> 16)) * 0x85EBCA6BU;
+		z = (z ^ (z >> 13)) * 0xC2B2AE35U;
+		return z ^ (z >> 16);
+	}
+
+	static inline double randUniformDouble(unsigned int &seed, double a, double b) { return (a==b) ? a : (a+(randNext(seed) * (1.0/4294967296.0))*(b-a)); }
 	static inline int randUniformInt(unsigned int &seed, int a, int b) { return (int)randUniformDouble(seed, (double)a, b+0.99); }
 
+	/**
+	 * @brief Get a random number around the interval [a, b], following a N(0.5, 1) distribution
+	 *        clamped to [0, 1.1] and scaled to the interval.
+	 *
+	 * The normal number is generated by Marsaglia's polar method, advancing the seed.
+	 */
 	static inline double randNormalDouble(unsigned int &seed, double a, double b) {
-		mt19937 gen(seed);
-		normal_distribution<double> normal(0.5, 1);
-		return (a==b) ? a : a+(min(max(normal(gen), 0.0), 1.1)*(b-a));
+		if(a==b) return a;
+		double u, v, s;
+		do {
+			u = 2 * (randNext(seed) * (1.0/4294967296.0)) - 1;
+			v = 2 * (randNext(seed) * (1.0/4294967296.0)) - 1;
+			s = u*u + v*v;
+		} while(s >= 1 || s == 0);
+		double normal = 0.5 + u * sqrt(-2 * log(s) / s);
+		return a+(min(max(normal, 0.0), 1.1)*(b-a));
 	}
 	static inline int randNormalInt(unsigned int &seed, int a, int b) { return (int)randNormalDouble(seed, (double)a, b+0.99); }
 
@@ -0,0 +1,215 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file ThreadPool.h
+ * @class ThreadPool
+ * @author Peter Frank Perroni
+ * @brief Intra-rank pool of worker threads used to evaluate a population in parallel.
+ * @details The pool is created once per TH instance and its threads are kept alive
+ *          during the whole optimization. Work is distributed with static chunking,
+ *          so the same worker always processes the same range of a batch, and every
+ *          worker owns its own random seed, derived deterministically from the base
+ *          seed and the worker index.
+ *
+ *          Only the thread that owns the pool (the one calling MPI) submits work,
+ *          and it also participates in the processing as the worker 0.
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+	std::vector<std::thread> workers;
+	std::mutex mtx;
+	std::condition_variable cvStart, cvDone;
+	const std::function<void(int, int, int)> *task;
+	std::exception_ptr taskError;
+	unsigned int *seeds;
+	long generation;
+	int taskCount;
+	int pending;
+	int nThreads;
+	bool stopping;
+
+	static int& currentWorker() {
+		static thread_local int worker = 0;
+		return worker;
+	}
+
+	/**
+	 * @brief Mix the base seed with the worker index (splitmix64 finalizer).
+	 */
+	static unsigned int deriveSeed(unsigned int baseSeed, int worker) {
+		unsigned long long z = baseSeed + 0x9E3779B97F4A7C15ULL * (unsigned long long)(worker + 1);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return (unsigned int)(z ^ (z >> 31));
+	}
+
+	void runChunk(int worker) {
+		int chunk = (taskCount + nThreads - 1) / nThreads;
+		int begin = worker * chunk;
+		int end = (begin + chunk < taskCount) ? begin + chunk : taskCount;
+		if(begin >= end) return;
+		try {
+			(*task)(begin, end, worker);
+		}
+		catch(...) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if(!taskError) taskError = std::current_exception();
+		}
+	}
+
+	void workerLoop(int worker) {
+		currentWorker() = worker;
+		long lastGeneration = 0;
+		while(true) {
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				cvStart.wait(lock, [&]{return stopping || generation != lastGeneration;});
+				if(stopping) return;
+				lastGeneration = generation;
+			}
+			runChunk(worker);
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				if(--pending == 0) cvDone.notify_one();
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructor to create the thread pool.
+	 * @param nThreads The total number of threads, including the calling thread.
+	 * @param baseSeed The seed used to derive the random seed of every worker.
+	 * @throws invalid_argument if the number of threads is less than one.
+	 */
+	ThreadPool(int nThreads, unsigned int baseSeed) {
+		if(nThreads < 1) throw std::invalid_argument("The number of threads must be greater than zero.");
+		this->nThreads = nThreads;
+		task = NULL;
+		generation = 0;
+		taskCount = 0;
+		pending = 0;
+		stopping = false;
+
+		seeds = new unsigned int[nThreads];
+		for(int i=0; i < nThreads; i++){
+			seeds[i] = deriveSeed(baseSeed, i);
+		}
+
+		currentWorker() = 0;
+		for(int i=1; i < nThreads; i++){
+			workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+		}
+	}
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			stopping = true;
+		}
+		cvStart.notify_all();
+		for(std::thread &worker : workers) worker.join();
+		delete[] seeds;
+	}
+
+	/**
+	 * @brief Execute a loop over the interval [0, count[ using all threads of the pool.
+	 *
+	 * The interval is split in (at most) one contiguous chunk per thread and the
+	 * function is called once per chunk, as func(begin, end, worker).
+	 * The method only returns after all chunks have been processed.
+	 * If any chunk throws an exception, the first one is rethrown to the caller.
+	 *
+	 * This method must be called only by the thread that owns the pool.
+	 *
+	 * @param count The number of iterations.
+	 * @param func The function that processes the iterations [begin, end[.
+	 */
+	void parallelFor(int count, const std::function<void(int, int, int)> &func) {
+		if(count <= 0) return;
+		if(nThreads == 1 || count == 1) {
+			func(0, count, 0);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			task = &func;
+			taskCount = count;
+			taskError = NULL;
+			pending = nThreads - 1;
+			generation++;
+		}
+		cvStart.notify_all();
+
+		runChunk(0);
+
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cvDone.wait(lock, [&]{return pending == 0;});
+			task = NULL;
+			error = taskError;
+			taskError = NULL;
+		}
+		if(error) std::rethrow_exception(error);
+	}
+
+	/**
+	 * @brief Get the random seed owned by a worker.
+	 *
+	 * The seed can be used with {@link THUtil::randUniformDouble()}
+	 * and must be accessed only by its own worker.
+	 *
+	 * @param worker The worker index, in the interval [0, {@link getNThreads()}[.
+	 * @return A reference to the worker's seed.
+	 */
+	unsigned int& getSeed(int worker) {
+		if(worker < 0 || worker >= nThreads) {
+			throw std::invalid_argument(std::string("Invalid worker index [") + std::to_string(worker) + "].");
+		}
+		return seeds[worker];
+	}
+
+	/**
+	 * @brief Get the index of the worker running the current thread.
+	 * @return The worker index (0 for the thread that owns the pool).
+	 */
+	static int getWorkerId() {
+		return currentWorker();
+	}
+
+	int getNThreads() {
+		return nThreads;
+	}
+};
+
+#endif /* THREADPOOL_H_ */
@@ -0,0 +1,89 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file TimedConvergenceControlPolicy.h
+ * @class TimedConvergenceControlPolicy
+ * @author Peter Frank Perroni
+ * @brief Convergence control policy that budgets every TH iteration in seconds.
+ * @details The optimization method runs until the first of these limits is reached:
+ *          - the time budget of the iteration (in seconds);
+ *          - the budget of fitness function evaluations (M);
+ *          - the deadline of the whole TH execution (see {@link THBuilder::setMaxTimeSeconds()});
+ *          - the stagnation reported by the optimization method.
+ *
+ *          Both time limits are also passed to the optimization method, which checks them
+ *          between its steps, so that a run cannot overrun the time allowed by more than
+ *          one step when the fitness evaluation costs vary widely across the search space.
+ *          Since every iteration takes about the same time on all TH instances, the instances
+ *          also tend to wait less for each other.
+ */
+
+#ifndef TIMEDCONVERGENCECONTROLPOLICY_H_
+#define TIMEDCONVERGENCECONTROLPOLICY_H_
+
+#include "ConvergenceControlPolicy.h"
+
+#include <chrono>
+#include <stdexcept>
+
+template <class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+class TimedConvergenceControlPolicy : public ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize> {
+	double seconds;
+
+public:
+	/**
+	 * @brief Constructor to setup the budgets of every TH iteration.
+	 * @param seconds The maximum time (in seconds) of every TH iteration.
+	 * @param M The maximum number of fitness function evaluations of every TH iteration
+	 *          (it is also used to size the local search over the children's results).
+	 * @throws invalid_argument if any budget is not positive.
+	 */
+	TimedConvergenceControlPolicy(double seconds, int M) : ConvergenceControlPolicy<P, pSize, F, fSize, V, vSize>(M) {
+		if(seconds <= 0) throw std::invalid_argument("The time budget must be greater than zero.");
+		if(M <= 0) throw std::invalid_argument("The evaluation budget must be greater than zero.");
+		this->seconds = seconds;
+	}
+
+	/**
+	 * @brief This method runs the optimization method until any of its budgets is exhausted.
+	 *
+	 * @param search The optimization method to run.
+	 */
+	void run(Search<P, pSize, F, fSize, V, vSize> *search) {
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now()
+				+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+		if(this->getDeadline() < deadline) deadline = this->getDeadline();
+		int M = this->getBudgetSize();
+
+		search->setDeadline(deadline);
+		search->startup();
+		do{
+			this->admitImmigrants(search);
+			search->next(M);
+		}while(search->getCurrentNEvals() < M && !search->isStuck() && !search->isTimeUp());
+		search->finalize();
+	}
+
+	double getSeconds() {
+		return seconds;
+	}
+};
+
+#endif /* TIMEDCONVERGENCECONTROLPOLICY_H_ */
@@ -30,4 +30,9 @@
 
 //#define RANDBEHAVIOR RANDRANDBEHAVIOR_DETERMINISTIC
 
+//#define RANDENGINE RANDENGINE_XOSHIRO256PP
+
+// Count the heap allocations of the steady-state iterations (see AllocationCounter.h).
+//#define TH_COUNT_ALLOCATIONS
+
 #endif /* CONFIG_H_ */
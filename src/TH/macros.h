@@ -40,6 +40,18 @@ enum{ MSG_STARTUP, MSG_CHILD2PARENT, MSG_PARENT2CHILD, MSG_FINALIZE };
 #define RANDBEHAVIOR_DETERMINISTIC 1	// Be aware that deterministic behavior also depends on external factors,
 										// like the optimization algorithms and execution configurations (wall clock time, number of evaluations, etc).
 
+#define RANDENGINE_XOSHIRO256PP 0	// Default random engine (see RandomEngine.h).
+#define RANDENGINE_PCG32 1
+#define RANDENGINE_COUNTER 2
+
+#define EXCHANGE_CODEC_RAW 0	// Default: positions exchanged in full, with their original type.
+#define EXCHANGE_CODEC_FP32 1	// Positions exchanged as 32-bit floats (lossy); unchanged solutions are not resent.
+#define EXCHANGE_CODEC_DELTA 2	// Only the positions changed since the last exchange (lossless); unchanged solutions are not resent.
+
+#define COMM_THREAD_IDLE_MICROSECONDS 20	// Pause of the communication thread when there is nothing to process.
+
+#define TH_MEMORY_ALIGNMENT 64	// Alignment (in bytes) of contiguous storage blocks (cache line and AVX-512 friendly).
+
 #define COPY_ARR(orig, dest, sz) for(int _i_=0; _i_ < sz; (dest)[_i_] = (orig)[_i_], _i_++);
 
 #ifdef DEBUG
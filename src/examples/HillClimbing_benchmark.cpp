@@ -0,0 +1,114 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file HillClimbing_benchmark.cpp
+ * @author Peter Frank Perroni
+ * @brief Benchmark of the cost per sweep of HillClimbing::next().
+ * @details A sweep moves every dimension of every individual once (percMove = 1),
+ *          i.e. populationSize * n evaluations through applyDelta().
+ *          The search algorithm runs standalone (without a TH instance), over the
+ *          Rosenbrock function, for a fixed number of sweeps per problem size.
+ *
+ *          Usage: mpirun -n 1 TH_HillClimbing_benchmark [sweeps]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+
+#include "config.h"
+
+#include "../TH/Solution.h"
+#include "../TH/SearchSpace.h"
+#include "../RosenbrockFitnessPolicy.h"
+#include "../HillClimbing.h"
+
+/**
+ * @brief Run the sweeps for n dimensions and return the average time per sweep, in milliseconds.
+ */
+double benchmark(int n, int populationSize, int nSweeps) {
+	int i, d;
+
+	map<Dimension<double>*, Partition<double>*> *partitions = new map<Dimension<double>*, Partition<double>*>();
+	Dimension<double>* dim;
+	for(i=0; i < n; i++){
+		dim = new Dimension<double>(i, -20, 20);
+		partitions->insert({dim, dim});
+	}
+	SearchSpace<double> *searchSpace = new SearchSpace<double>(partitions);
+	RosenbrockFitnessPolicy *fitnessPolicy = new RosenbrockFitnessPolicy();
+
+	// Deterministic starting points, so that every run performs the same moves.
+	Solution<> **population = new Solution<>*[populationSize];
+	for(i=0; i < populationSize; i++){
+		population[i] = new Solution<>(n);
+		for(d=0; d < n; d++){
+			*(*population[i])[d] = (double)((i*7919 + d*104729) % 4000 - 2000) / 100;
+		}
+		fitnessPolicy->apply(population[i]);
+	}
+
+	HillClimbing<> *hillClimbing = new HillClimbing<>(1, 0.01, populationSize);
+	hillClimbing->setPopulation(population, populationSize);
+	hillClimbing->setFitnessPolicy(fitnessPolicy);
+	hillClimbing->setSearchSpace(searchSpace);
+	hillClimbing->startup();
+
+	int M = nSweeps * populationSize * n;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while(hillClimbing->getCurrentNEvals() < M && !hillClimbing->isStuck()) hillClimbing->next(M);
+	double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	double sweeps = (double)hillClimbing->getCurrentNEvals() / ((double)populationSize * n);
+
+	delete hillClimbing;
+	for(i=0; i < populationSize; i++) delete population[i];
+	delete[] population;
+	delete fitnessPolicy;
+	delete searchSpace;
+	for(auto elem = partitions->begin(); elem != partitions->end(); ++elem) {
+		delete (Dimension<>*)elem->first;
+	}
+	delete partitions;
+
+	return (sweeps > 0) ? elapsed / sweeps : 0;
+}
+
+int main(int argc, char *argv[]) {
+	int sizes[] = {100, 1000, 4000};
+	int populationSize = 12;
+	int nSweeps = (argc > 1) ? atoi(argv[1]) : 20;
+	if(nSweeps <= 0) {
+		std::cerr << "The number of sweeps must be greater than zero." << std::endl;
+		return 1;
+	}
+
+	MPI_Init(&argc, &argv);
+	std::cout << "HillClimbing: " << populationSize << " individuals, percMove = 1, "
+				<< nSweeps << " sweeps." << std::endl;
+	std::cout << std::setw(8) << "n" << std::setw(16) << "ms/sweep" << std::endl;
+	for(int n : sizes) {
+		std::cout << std::setw(8) << n << std::setw(16) << std::fixed << std::setprecision(3)
+					<< benchmark(n, populationSize, nSweeps) << std::endl;
+	}
+	MPI_Finalize();
+	return 0;
+}
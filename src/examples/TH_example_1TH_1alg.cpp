@@ -85,7 +85,7 @@ void runTH(int argc, char *argv[]) {
 	int ID = th->getID();
 	std::cout << "[" << ID << "] Best Result: Num.Evals = " << th->getNEvals()
 				<< ", Fitness = " << th->getBestSolution()->getFitness()->getFirstValue() << std::endl;
-	if(ID == thTree->getRootNode()->getID()) {
+	if(ID == thTree->getRootID()) {
 		std::cout << "Overal Best Solution : ";
 		printSolution(th->getBestSolution());
 		std::cout << std::endl;
@@ -0,0 +1,110 @@
+/**
+ * Treasure Hunt Framework (c)
+ *
+ * Copyright 2016-2020 Peter Frank Perroni
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For additional notifications, please check the file NOTICE.txt.
+ *
+ *
+ * @file TH_test_allocations.cpp
+ * @author Peter Frank Perroni
+ * @brief Check that the steady-state iterations of the TH instances do not allocate memory.
+ * @details Runs one TH instance per MPI process, with 2 search algorithms, over a binary
+ *          tree topology (e.g. the 7-TH tree of TH_example_7TH with 7 processes), so that
+ *          the parent/child exchanges are also covered. The allocation counting is enabled
+ *          (see AllocationCounter.h) and DEBUG is disabled, since the DEBUG messages
+ *          allocate memory by themselves.
+ *
+ *          Every process exits with a non-zero status unless no allocation was counted
+ *          after the first iteration of its TH instance.
+ *
+ *          Usage: mpirun -n <number of TH instances> TH_test_allocations
+ */
+
+#include <iostream>
+#include <map>
+
+#include "config.h"
+#undef DEBUG
+
+#define TH_COUNT_ALLOCATIONS
+#define TH_DEFINE_ALLOCATION_OPERATORS
+#include "../TH/AllocationCounter.h"
+
+#include "../TH/THBuilder.h"
+#include "../TH/Solution.h"
+#include "../TH/KAryTHTree.h"
+#include "../TH/GroupRegionSelectionPolicy.h"
+#include "../RosenbrockFitnessPolicy.h"
+#include "../PSO.h"
+#include "../HillClimbing.h"
+
+template<class P = double, int pSize = 1, class F = double, int fSize = 1, class V = double, int vSize = 1>
+long long runTH(int argc, char *argv[]) {
+	int i;
+
+	// Create the search space boundaries.
+	map<Dimension<P>*, Partition<P>*> *partitions = new map<Dimension<P>*, Partition<P>*>();
+	Dimension<P>* dim;
+	int n = 200;
+	for(i=0; i < n; i++){
+		dim = new Dimension<P>(i, -20, 20); // Dimension limits.
+		partitions->insert({dim, dim}); // Partition equals dimension boundaries for full search space.
+	}
+
+	// Set the configuration required to build the TH instances, one per MPI process.
+	THBuilder<P, pSize, F, fSize, V, vSize> *thBuilder = new THBuilder<P, pSize, F, fSize, V, vSize>();
+	thBuilder->setMpiComm(argc, argv);
+	int nProcs;
+	MPI_Comm_size(thBuilder->getCartGrid(), &nProcs);
+
+	// Mount the TH tree topology: a binary tree over all the processes.
+	THTree* thTree = new KAryTHTree(nProcs, 2);
+
+	thBuilder->setTHTree(thTree)
+			->setSearchSpace(new SearchSpace<P>(partitions))
+			->setFitnessPolicy(new RosenbrockFitnessPolicy())
+			->setRegionSelectionPolicy(new GroupRegionSelectionPolicy<P, pSize, F, fSize, V, vSize>(1, 2))
+			->addSearchAlgorithm(new PSO<P, pSize, F, fSize, V, vSize>(0.9, 0.7, 0.7, 12))
+			->addSearchAlgorithm(new HillClimbing<P, pSize, F, fSize, V, vSize>(0.1, 0.01, 12))
+			->setBestListSize(2)
+			->setMaxTimeSeconds(3);
+
+	// Build and execute the TH instance.
+	TH<P, pSize, F, fSize, V, vSize> *th = thBuilder->build();
+	th->run();
+
+	long long allocations = th->getSteadyStateAllocations();
+	std::cout << "[" << th->getID() << "] Num.Evals = " << th->getNEvals()
+				<< ", Steady-state allocations = " << allocations << std::endl;
+
+	for(auto elem = partitions->begin(); elem != partitions->end(); ++elem) {
+		delete (Dimension<>*)elem->first;
+	}
+	delete partitions;
+	delete th; // Do NOT delete the builder, since it will be deleted by TH instance.
+	return allocations;
+}
+
+int main(int argc, char *argv[]) {
+	long long allocations = runTH<>(argc, argv);
+	if(allocations != 0) {
+		std::cerr << "FAILED: the steady-state iterations allocated memory "
+					<< "(" << allocations << " allocations; -1 means the counting is disabled)." << std::endl;
+		return 1;
+	}
+	std::cout << "PASSED" << std::endl;
+	return 0;
+}